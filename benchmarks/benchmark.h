@@ -0,0 +1,43 @@
+#pragma once
+
+#include "common/common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+/// Number of times each measurement is repeated. The fastest run is reported, being the one least disturbed by the rest of the system.
+#define BENCHMARK_RUNS 5
+
+/// Milliseconds taken by the fastest of BENCHMARK_RUNS runs. setup is called before every run and is not measured.
+inline double MeasureMilliseconds(const Function<void()>& run, const Function<void()>& setup = nullptr)
+{
+	double best = std::numeric_limits<double>::max();
+	for (int i = 0; i < BENCHMARK_RUNS; i++)
+	{
+		if (setup)
+		{
+			setup();
+		}
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		run();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		best = std::min(best, elapsed.count());
+	}
+	return best;
+}
+
+/// Print a measurement of items processed in milliseconds as a row of the results table.
+inline void ReportBenchmark(const String& name, size_t items, double milliseconds)
+{
+	printf("%-48s %10zu items %12.3f ms %10.2f ns/item\n", name.c_str(), items, milliseconds, items ? milliseconds * 1e6 / items : 0.0);
+}
+
+/// Stops the compiler from optimizing away work whose result is otherwise unused.
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+	static volatile T s_Sink;
+	s_Sink = value;
+}
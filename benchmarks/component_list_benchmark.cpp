@@ -0,0 +1,132 @@
+#include "benchmark.h"
+
+#include "framework/system.h"
+
+#include <algorithm>
+#include <random>
+
+/// Number of components created and destroyed by each measurement, around the size of a large level.
+#define COMPONENT_COUNT 100000
+
+/// Small component standing in for the components of a level being loaded and unloaded.
+class CountedComponent : public Component
+{
+public:
+	unsigned int m_Value;
+
+	CountedComponent(unsigned int value)
+	    : m_Value(value)
+	{
+	}
+
+	ComponentID getComponentID() const override { return Component::s_ID; }
+	String getName() const override { return "CountedComponent"; }
+};
+
+/// Reaches the component lists the same way EntityFactory and Entity do.
+class ComponentListBenchmark : public System
+{
+public:
+	static void Create(Vector<Component*>& components)
+	{
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++)
+		{
+			components.push_back(new CountedComponent(i));
+			RegisterComponent(components.back());
+		}
+	}
+
+	static void Destroy(const Vector<Component*>& components, const Vector<unsigned int>& order)
+	{
+		for (auto& index : order)
+		{
+			DeregisterComponent(components[index]);
+			delete components[index];
+		}
+	}
+
+	/// Removal as it was done before components remembered their position, searching and shifting the list.
+	static void DestroyWithErase(Vector<Component*>& list, const Vector<Component*>& components, const Vector<unsigned int>& order)
+	{
+		for (auto& index : order)
+		{
+			list.erase(std::find(list.begin(), list.end(), components[index]));
+			delete components[index];
+		}
+	}
+
+	static bool IsEmpty() { return GetComponents(Component::s_ID).empty(); }
+};
+
+int main()
+{
+	printf("Component create and destroy benchmark with %d components\n", COMPONENT_COUNT);
+
+	Vector<unsigned int> creationOrder(COMPONENT_COUNT);
+	for (unsigned int i = 0; i < COMPONENT_COUNT; i++)
+	{
+		creationOrder[i] = i;
+	}
+	Vector<unsigned int> reverseOrder(creationOrder.rbegin(), creationOrder.rend());
+	Vector<unsigned int> randomOrder = creationOrder;
+	std::shuffle(randomOrder.begin(), randomOrder.end(), std::mt19937(42));
+
+	Vector<Component*> components;
+	components.reserve(COMPONENT_COUNT);
+
+	double createTime = MeasureMilliseconds(
+	    [&]() { ComponentListBenchmark::Create(components); },
+	    [&]() {
+		    ComponentListBenchmark::Destroy(components, Vector<unsigned int>(creationOrder.begin(), creationOrder.begin() + components.size()));
+		    components.clear();
+	    });
+	ReportBenchmark("Create and register", COMPONENT_COUNT, createTime);
+	ComponentListBenchmark::Destroy(components, creationOrder);
+
+	struct Order
+	{
+		String m_Name;
+		const Vector<unsigned int>* m_Indices;
+	};
+	const Vector<Order> orders = {
+		{ "creation order", &creationOrder },
+		{ "reverse order", &reverseOrder },
+		{ "random order", &randomOrder },
+	};
+
+	for (auto& order : orders)
+	{
+		double destroyTime = MeasureMilliseconds(
+		    [&]() { ComponentListBenchmark::Destroy(components, *order.m_Indices); },
+		    [&]() {
+			    components.clear();
+			    ComponentListBenchmark::Create(components);
+		    });
+		ReportBenchmark("Deregister and destroy, " + order.m_Name, COMPONENT_COUNT, destroyTime);
+	}
+
+	if (!ComponentListBenchmark::IsEmpty())
+	{
+		printf("Components were left registered after destroying all of them\n");
+		return 1;
+	}
+
+	// Same removals from a plain list with erase, to compare against the swap-and-pop in DeregisterComponent()
+	Vector<Component*> list;
+	for (auto& order : orders)
+	{
+		double eraseTime = MeasureMilliseconds(
+		    [&]() { ComponentListBenchmark::DestroyWithErase(list, components, *order.m_Indices); },
+		    [&]() {
+			    components.clear();
+			    for (unsigned int i = 0; i < COMPONENT_COUNT; i++)
+			    {
+				    components.push_back(new CountedComponent(i));
+			    }
+			    list = components;
+		    });
+		ReportBenchmark("Erase and destroy, " + order.m_Name, COMPONENT_COUNT, eraseTime);
+	}
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include "benchmark.h"
+
+#include "os/thread.h"
+
+#include <thread>
+
+/// Items pushed by every producer thread.
+#define ITEMS_PER_PRODUCER 200000
+
+/// Item identifying its producer and its position in that producer's sequence.
+struct StressItem
+{
+	unsigned int m_Producer;
+	unsigned int m_Sequence;
+	/// Keeps a count that goes back to 1 only if the queue destroys every item it moved.
+	Ref<int> m_Payload;
+};
+
+/// Push from producerCount threads while the calling thread drains the queue, like worker threads posting
+/// deferred events while the main thread dispatches them. Returns false if any item was lost, duplicated or reordered.
+static bool StressQueue(unsigned int producerCount)
+{
+	ConcurrentQueue<StressItem> queue;
+	Ref<int> payload(new int(0));
+	Atomic<unsigned int> finishedProducers(0);
+	Atomic<bool> start(false);
+
+	Vector<std::thread> producers;
+	for (unsigned int producer = 0; producer < producerCount; producer++)
+	{
+		producers.emplace_back([&, producer]() {
+			while (!start)
+			{
+				std::this_thread::yield();
+			}
+			for (unsigned int sequence = 0; sequence < ITEMS_PER_PRODUCER; sequence++)
+			{
+				queue.push({ producer, sequence, payload });
+			}
+			finishedProducers++;
+		});
+	}
+
+	// Items of each producer should arrive in the order they were pushed, each exactly once
+	Vector<unsigned int> nextSequence(producerCount, 0);
+	Vector<StressItem> items;
+	size_t received = 0;
+	bool isValid = true;
+
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	start = true;
+	bool isLastDrain = false;
+	while (!isLastDrain)
+	{
+		// Producers are done before this last drain starts, so it picks up everything left over
+		isLastDrain = finishedProducers.load() == producerCount;
+
+		items.clear();
+		queue.popAll(items);
+		for (auto& item : items)
+		{
+			if (item.m_Producer >= producerCount || item.m_Sequence != nextSequence[item.m_Producer])
+			{
+				isValid = false;
+				continue;
+			}
+			nextSequence[item.m_Producer]++;
+		}
+		received += items.size();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+	items.clear();
+
+	size_t expected = (size_t)producerCount * ITEMS_PER_PRODUCER;
+	isValid = isValid && received == expected && queue.isEmpty() && payload.use_count() == 1;
+	ReportBenchmark(std::to_string(producerCount) + " producers, 1 consumer", received, elapsed.count());
+	if (!isValid)
+	{
+		printf("FAILED: expected %zu items in order, received %zu, %ld payload references left\n", expected, received, payload.use_count() - 1);
+	}
+	return isValid;
+}
+
+int main()
+{
+	unsigned int threads = std::max(std::thread::hardware_concurrency(), 2u);
+	printf("ConcurrentQueue stress test on %u hardware threads\n", std::thread::hardware_concurrency());
+
+	bool isValid = true;
+	for (unsigned int producers : { 1u, threads, threads * 4 })
+	{
+		isValid = StressQueue(producers) && isValid;
+	}
+
+	printf(isValid ? "All items arrived exactly once and in order\n" : "Stress test failed\n");
+	return isValid ? 0 : 1;
+}
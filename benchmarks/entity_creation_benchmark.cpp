@@ -0,0 +1,78 @@
+#include "benchmark.h"
+
+#include "framework/entity_factory.h"
+
+/// Entities created from JSON by each measurement.
+#define ENTITY_COUNT 1000
+/// Creator lookups done by each lookup measurement.
+#define LOOKUP_COUNT 100000
+
+/// Creator search as it was done before EntityFactory indexed the creators by name, comparing against every registered name.
+static int FindCreatorByScan(const ComponentDatabase& database, const String& name)
+{
+	for (int i = 0; i < database.size(); i++)
+	{
+		if (std::get<String>(database[i]) == name)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+int main()
+{
+	EntityFactory* factory = EntityFactory::GetSingleton();
+	const ComponentDatabase& database = factory->getComponentDatabase();
+	printf("Entity creation benchmark with %zu registered component types\n", database.size());
+
+	// Every registered name in turn, so that names late in the registration order are looked up as often as early ones
+	Vector<String> names;
+	names.reserve(LOOKUP_COUNT);
+	for (int i = 0; i < LOOKUP_COUNT; i++)
+	{
+		names.push_back(std::get<String>(database[i % database.size()]));
+	}
+
+	double indexTime = MeasureMilliseconds([&]() {
+		int sum = 0;
+		for (auto& name : names)
+		{
+			sum += factory->getComponentCreatorIndex(name);
+		}
+		DoNotOptimize(sum);
+	});
+	ReportBenchmark("Creator lookup by index", LOOKUP_COUNT, indexTime);
+
+	double scanTime = MeasureMilliseconds([&]() {
+		int sum = 0;
+		for (auto& name : names)
+		{
+			sum += FindCreatorByScan(database, name);
+		}
+		DoNotOptimize(sum);
+	});
+	ReportBenchmark("Creator lookup by scan", LOOKUP_COUNT, scanTime);
+
+	// Components late in the registration order were the slowest to find before the index
+	JSON::json entityJSON;
+	entityJSON["Entity"]["name"] = "BenchmarkEntity";
+	entityJSON["Components"]["TestComponent"] = JSON::json::object();
+	entityJSON["Components"]["TransformComponent"]["position"] = { { "x", 0.0f }, { "y", 0.0f }, { "z", 0.0f } };
+	entityJSON["Components"]["TransformComponent"]["rotation"] = { { "x", 0.0f }, { "y", 0.0f }, { "z", 0.0f }, { "w", 1.0f } };
+	entityJSON["Components"]["TransformComponent"]["scale"] = { { "x", 1.0f }, { "y", 1.0f }, { "z", 1.0f } };
+	entityJSON["Components"]["TriggerComponent"]["targetEntityID"] = INVALID_ID;
+
+	double createTime = MeasureMilliseconds(
+	    [&]() {
+		    for (int i = 0; i < ENTITY_COUNT; i++)
+		    {
+			    factory->createEntity(entityJSON, "benchmark");
+		    }
+	    },
+	    [&]() { factory->destroyEntities(); });
+	ReportBenchmark("createEntity with 3 components", ENTITY_COUNT, createTime);
+
+	factory->destroyEntities();
+	return 0;
+}
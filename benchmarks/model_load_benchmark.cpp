@@ -0,0 +1,116 @@
+#include "benchmark.h"
+
+#include "core/cooked_model.h"
+#include "os/os.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+/// Imports the model with the post processing ResourceLoader::ImportAssimp() asks for and sums its vertices.
+static size_t ImportWithAssimp(const String& modelPath)
+{
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(
+	    OS::GetAbsolutePath(modelPath).generic_string(),
+	    aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeMeshes | aiProcess_CalcTangentSpace);
+	if (!scene)
+	{
+		return 0;
+	}
+
+	size_t vertexCount = 0;
+	for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+	{
+		vertexCount += scene->mMeshes[i]->mNumVertices;
+	}
+	return vertexCount;
+}
+
+/// Reads the cooked model and walks its vertices the way ResourceLoader::LoadCookedModel() hands them to the GPU.
+static size_t ReadCooked(const String& cookedPath)
+{
+	FileBuffer buffer = OS::LoadFileContents(cookedPath);
+	Ptr<CookedModel> cooked = CookedModel::Open(buffer.data(), buffer.size());
+	if (!cooked)
+	{
+		return 0;
+	}
+
+	size_t vertexCount = 0;
+	float positionSum = 0.0f;
+	for (unsigned int i = 0; i < cooked->getMeshCount(); i++)
+	{
+		const CookedModel::MeshEntry& mesh = cooked->getMesh(i);
+		const VertexData* vertices = cooked->getVertices(mesh);
+		for (unsigned int v = 0; v < mesh.m_VertexCount; v++)
+		{
+			positionSum += vertices[v].m_Position.x;
+		}
+		vertexCount += mesh.m_VertexCount;
+	}
+	DoNotOptimize(positionSum);
+	return vertexCount;
+}
+
+/// Times loading each model given on the command line, or a few test models of different sizes, through Assimp and from its cooked model.
+/// Cook the models with Assets > Cook Models in the editor first.
+int main(int argc, char* argv[])
+{
+	if (!OS::Initialize())
+	{
+		printf("Could not initialize the OS layer\n");
+		return 1;
+	}
+
+	Vector<String> modelPaths;
+	for (int i = 1; i < argc; i++)
+	{
+		modelPaths.push_back(argv[i]);
+	}
+	if (modelPaths.empty())
+	{
+		modelPaths = {
+			"game/assets/test/teapot.obj",
+			"game/assets/test/suzanne.obj",
+			"game/assets/test/glass.obj",
+			"game/assets/test/animal.obj",
+		};
+	}
+
+	printf("Model load benchmark, Assimp import against reading the cooked model\n");
+	for (auto& modelPath : modelPaths)
+	{
+		if (!OS::IsExists(modelPath))
+		{
+			printf("Model not found: %s\n", modelPath.c_str());
+			continue;
+		}
+
+		size_t importedVertices = 0;
+		double importTime = MeasureMilliseconds([&]() {
+			importedVertices = ImportWithAssimp(modelPath);
+		});
+		ReportBenchmark("Assimp " + modelPath, importedVertices, importTime);
+
+		String cookedPath = CookedModel::GetCookedPath(modelPath);
+		if (!OS::IsExists(cookedPath))
+		{
+			printf("No cooked model for %s, cook it to compare\n", modelPath.c_str());
+			continue;
+		}
+
+		size_t cookedVertices = 0;
+		double cookedTime = MeasureMilliseconds([&]() {
+			cookedVertices = ReadCooked(cookedPath);
+		});
+		ReportBenchmark("Cooked " + cookedPath, cookedVertices, cookedTime);
+
+		if (cookedVertices != importedVertices)
+		{
+			printf("Cooked model has %zu vertices, the import has %zu. The model may have changed since it was cooked\n", cookedVertices, importedVertices);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+#include "benchmark.h"
+
+#include "framework/component.h"
+#include "framework/packed_storage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+/// Components walked by each measurement, around the number of entities of a large level.
+#define COMPONENT_COUNT 50000
+
+/// Settings of a light, laid out like PointLight.
+struct LightSettings
+{
+	float m_Attenuation[3];
+	float m_Range;
+	float m_Intensity;
+	float m_Color[8];
+};
+
+/// Light component keeping its settings inside the component, the way components did before PackedStorage.
+class InlineLightComponent : public Component
+{
+public:
+	LightSettings m_Settings;
+	/// Other members of a typical component, which the walk drags into the cache along with the settings.
+	char m_OtherMembers[128];
+
+	InlineLightComponent(const LightSettings& settings)
+	    : m_Settings(settings)
+	{
+	}
+
+	ComponentID getComponentID() const override { return Component::s_ID; }
+	String getName() const override { return "InlineLightComponent"; }
+};
+
+/// Light component keeping its settings in a PackedStorage, the way PointLightComponent does.
+class PackedLightComponent : public Component
+{
+	LightSettings* m_PackedData;
+	unsigned int m_PackedIndex;
+	friend class PackedStorage<LightSettings, PackedLightComponent>;
+
+public:
+	static PackedStorage<LightSettings, PackedLightComponent> s_Storage;
+
+	char m_OtherMembers[128];
+
+	PackedLightComponent(const LightSettings& settings)
+	{
+		s_Storage.add(this, settings);
+	}
+	~PackedLightComponent()
+	{
+		s_Storage.remove(this);
+	}
+
+	ComponentID getComponentID() const override { return Component::s_ID; }
+	String getName() const override { return "PackedLightComponent"; }
+};
+
+PackedStorage<LightSettings, PackedLightComponent> PackedLightComponent::s_Storage;
+
+static float Brightness(const LightSettings& settings)
+{
+	return settings.m_Intensity * settings.m_Range / (settings.m_Attenuation[0] + settings.m_Attenuation[1] + settings.m_Attenuation[2]);
+}
+
+int main()
+{
+	printf("Packed storage benchmark over %d light components\n", COMPONENT_COUNT);
+
+	std::mt19937 random(42);
+	LightSettings settings = { { 1.0f, 0.1f, 0.01f }, 10.0f, 1.0f, {} };
+
+	// Components of a level that has been edited for a while are no longer laid out in the order their system walks them
+	Vector<Component*> inlineLights;
+	Vector<Component*> packedLights;
+	for (int i = 0; i < COMPONENT_COUNT; i++)
+	{
+		settings.m_Range = (float)(i % 100);
+		inlineLights.push_back(new InlineLightComponent(settings));
+		packedLights.push_back(new PackedLightComponent(settings));
+	}
+	std::shuffle(inlineLights.begin(), inlineLights.end(), random);
+	std::shuffle(packedLights.begin(), packedLights.end(), random);
+
+	float inlineSum = 0.0f;
+	double inlineTime = MeasureMilliseconds([&]() {
+		inlineSum = 0.0f;
+		for (auto& component : inlineLights)
+		{
+			inlineSum += Brightness(((InlineLightComponent*)component)->m_Settings);
+		}
+	});
+	ReportBenchmark("Walk components through pointers", COMPONENT_COUNT, inlineTime);
+
+	float packedSum = 0.0f;
+	double packedTime = MeasureMilliseconds([&]() {
+		packedSum = 0.0f;
+		PackedLightComponent::s_Storage.eachChunk([&](LightSettings* data, PackedLightComponent* const* owners, unsigned int count) {
+			for (unsigned int i = 0; i < count; i++)
+			{
+				packedSum += Brightness(data[i]);
+			}
+		});
+	});
+	ReportBenchmark("Walk packed storage", COMPONENT_COUNT, packedTime);
+
+	// Removing half the components in random order checks that the storage stays consistent
+	double removeTime = MeasureMilliseconds(
+	    [&]() {
+		    for (size_t i = COMPONENT_COUNT / 2; i < COMPONENT_COUNT; i++)
+		    {
+			    delete packedLights[i];
+		    }
+		    packedLights.resize(COMPONENT_COUNT / 2);
+	    },
+	    [&]() {
+		    while (packedLights.size() < COMPONENT_COUNT)
+		    {
+			    packedLights.push_back(new PackedLightComponent(settings));
+		    }
+		    std::shuffle(packedLights.begin(), packedLights.end(), random);
+	    });
+	ReportBenchmark("Remove from packed storage", COMPONENT_COUNT / 2, removeTime);
+
+	bool isValid = std::abs(inlineSum - packedSum) <= 1e-3f * std::abs(inlineSum) && PackedLightComponent::s_Storage.size() == packedLights.size();
+	for (auto& component : inlineLights)
+	{
+		delete component;
+	}
+	for (auto& component : packedLights)
+	{
+		delete component;
+	}
+
+	isValid = isValid && PackedLightComponent::s_Storage.size() == 0;
+	printf(isValid ? "Packed walk matches the pointer walk\n" : "FAILED: packed walk differs from the pointer walk\n");
+	return isValid ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include "benchmark.h"
+
+#include "framework/component.h"
+#include "os/thread.h"
+
+/// Stand-in for a gameplay component. Allocated from the component pools and reached through Component*, like the components in System::s_Components.
+class MovingComponent : public Component
+{
+public:
+	float m_Position[3];
+	float m_Velocity[3];
+
+	MovingComponent(float seed)
+	    : m_Position { seed, seed * 0.5f, seed * 0.25f }
+	    , m_Velocity { 1.0f, -0.5f, 0.25f }
+	{
+	}
+
+	ComponentID getComponentID() const override { return Component::s_ID; }
+	String getName() const override { return "MovingComponent"; }
+};
+
+/// Per component work of a typical update, like TransformAnimationSystem moving transforms.
+static void Move(Component* component, float deltaSeconds)
+{
+	MovingComponent* moving = (MovingComponent*)component;
+	for (int i = 0; i < 3; i++)
+	{
+		moving->m_Velocity[i] *= 0.999f;
+		moving->m_Position[i] += moving->m_Velocity[i] * deltaSeconds;
+	}
+}
+
+/// Per component work of a typical gather, like LightSystem finding the lights closest to the camera.
+static float DistanceSquared(Component* component)
+{
+	MovingComponent* moving = (MovingComponent*)component;
+	return moving->m_Position[0] * moving->m_Position[0] + moving->m_Position[1] * moving->m_Position[1] + moving->m_Position[2] * moving->m_Position[2];
+}
+
+static void RunCount(ThreadPool& pool, size_t count)
+{
+	Vector<Component*> components;
+	components.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		components.push_back(new MovingComponent((float)i));
+	}
+
+	const float deltaSeconds = 1.0f / 60.0f;
+	const String countName = std::to_string(count / 1000) + "k";
+
+	double serialTime = MeasureMilliseconds([&]() {
+		for (auto& component : components)
+		{
+			Move(component, deltaSeconds);
+		}
+	});
+	ReportBenchmark("Serial for " + countName, count, serialTime);
+
+	for (size_t grainSize : { (size_t)64, (size_t)DEFAULT_GRAIN_SIZE, (size_t)4096 })
+	{
+		double parallelTime = MeasureMilliseconds([&]() {
+			pool.parallelFor(
+			    components.size(), [&](size_t begin, size_t end) {
+				    for (size_t i = begin; i < end; i++)
+				    {
+					    Move(components[i], deltaSeconds);
+				    }
+			    },
+			    grainSize);
+		});
+		ReportBenchmark("parallelFor " + countName + ", grain " + std::to_string(grainSize), count, parallelTime);
+	}
+
+	float serialMax = 0.0f;
+	double serialReduceTime = MeasureMilliseconds([&]() {
+		serialMax = 0.0f;
+		for (auto& component : components)
+		{
+			serialMax = std::max(serialMax, DistanceSquared(component));
+		}
+	});
+	ReportBenchmark("Serial reduce " + countName, count, serialReduceTime);
+
+	float parallelMax = 0.0f;
+	double parallelReduceTime = MeasureMilliseconds([&]() {
+		parallelMax = pool.parallelReduce<float>(
+		    components.size(), 0.0f, [&](size_t begin, size_t end) {
+			    float batchMax = 0.0f;
+			    for (size_t i = begin; i < end; i++)
+			    {
+				    batchMax = std::max(batchMax, DistanceSquared(components[i]));
+			    }
+			    return batchMax;
+		    },
+		    [](const float& a, const float& b) { return std::max(a, b); });
+	});
+	ReportBenchmark("parallelReduce " + countName, count, parallelReduceTime);
+
+	if (serialMax != parallelMax)
+	{
+		printf("parallelReduce result %f differs from the serial result %f\n", parallelMax, serialMax);
+	}
+
+	for (auto& component : components)
+	{
+		delete component;
+	}
+}
+
+int main()
+{
+	ThreadPool pool;
+	printf("parallelFor and parallelReduce benchmark on %u workers and the main thread\n", pool.getWorkerCount());
+
+	for (size_t count : { (size_t)10000, (size_t)100000, (size_t)1000000 })
+	{
+		RunCount(pool, count);
+	}
+
+	pool.join();
+	return 0;
+}
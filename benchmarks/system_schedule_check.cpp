@@ -0,0 +1,40 @@
+#include "benchmark.h"
+
+#include "framework/systems/transform_animation_system.h"
+#include "framework/systems/light_system.h"
+#include "framework/systems/audio_position_system.h"
+
+/// Creates the systems that declare their component access in the order Application creates them,
+/// then checks that System::UpdateSystems() gets at least two systems to run concurrently.
+int main()
+{
+	TransformAnimationSystem::GetSingleton();
+	LightSystem::GetSingleton();
+	AudioPositionSystem::GetSingleton();
+
+	bool isConcurrent = false;
+	for (auto& stage : System::GetUpdateStages())
+	{
+		String names;
+		for (auto& system : stage)
+		{
+			names += system->getName() + " ";
+		}
+		printf("Stage of %zu: %s\n", stage.size(), names.c_str());
+
+		for (int i = 0; i < stage.size(); i++)
+		{
+			for (int j = i + 1; j < stage.size(); j++)
+			{
+				if (!stage[i]->isConflicting(stage[j]))
+				{
+					printf("%s and %s run concurrently\n", stage[i]->getName().c_str(), stage[j]->getName().c_str());
+					isConcurrent = true;
+				}
+			}
+		}
+	}
+
+	printf(isConcurrent ? "Found systems running concurrently\n" : "FAILED: every system runs alone\n");
+	return isConcurrent ? 0 : 1;
+}
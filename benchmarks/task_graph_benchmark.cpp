@@ -0,0 +1,101 @@
+#include "benchmark.h"
+
+#include "os/thread.h"
+
+/// Iterations of busy work run by each task of the loaded graphs. Takes around a microsecond.
+#define TASK_WORK_ITERATIONS 250
+
+/// Tasks in depth layers of width tasks each. Every task depends on the task in the same column and on the one
+/// to its right in the previous layer, so each layer can only start once the one before it is done.
+static Vector<Ref<Task>> BuildLayeredGraph(size_t width, size_t depth, const Function<void()>& work)
+{
+	Vector<Ref<Task>> tasks;
+	tasks.reserve(width * depth);
+	for (size_t layer = 0; layer < depth; layer++)
+	{
+		for (size_t column = 0; column < width; column++)
+		{
+			tasks.emplace_back(new Task(work));
+			if (layer > 0)
+			{
+				size_t previousLayer = (layer - 1) * width;
+				tasks[previousLayer + column]->addContinuation(tasks.back());
+				if (width > 1)
+				{
+					tasks[previousLayer + (column + 1) % width]->addContinuation(tasks.back());
+				}
+			}
+		}
+	}
+	return tasks;
+}
+
+/// Same layers as BuildLayeredGraph() without the edges. Layers are submitted one at a time and waited on instead.
+static void RunLayersWithBarriers(ThreadPool& pool, size_t width, size_t depth, const Function<void()>& work)
+{
+	for (size_t layer = 0; layer < depth; layer++)
+	{
+		Vector<Ref<Task>> tasks;
+		tasks.reserve(width);
+		for (size_t column = 0; column < width; column++)
+		{
+			tasks.emplace_back(new Task(work));
+		}
+		pool.wait(pool.submit(tasks));
+	}
+}
+
+static void RunShape(ThreadPool& pool, const String& shape, size_t width, size_t depth, const Function<void()>& work, const String& workName)
+{
+	Vector<Ref<Task>> graph = BuildLayeredGraph(width, depth, work);
+	double graphTime = MeasureMilliseconds([&]() {
+		pool.wait(pool.submit(graph));
+	});
+	ReportBenchmark(shape + " graph, " + workName, graph.size(), graphTime);
+
+	double barrierTime = MeasureMilliseconds([&]() {
+		RunLayersWithBarriers(pool, width, depth, work);
+	});
+	ReportBenchmark(shape + " layers with barriers, " + workName, width * depth, barrierTime);
+}
+
+int main()
+{
+	ThreadPool pool;
+	printf("Task graph benchmark on %u workers and the main thread\n", pool.getWorkerCount());
+
+	Function<void()> empty = []() {};
+	Function<void()> busy = []() {
+		float value = 1.0f;
+		for (int i = 0; i < TASK_WORK_ITERATIONS; i++)
+		{
+			value = value * 1.0001f + 0.5f;
+		}
+		DoNotOptimize(value);
+	};
+
+	struct Shape
+	{
+		String m_Name;
+		size_t m_Width;
+		size_t m_Depth;
+	};
+	const Vector<Shape> shapes = {
+		{ "Wide 4096x4", 4096, 4 },
+		{ "Square 256x256", 256, 256 },
+		{ "Deep 4x4096", 4, 4096 },
+	};
+
+	// Empty tasks measure the scheduling overhead per task, busy tasks show how well the graph keeps workers fed
+	for (auto& shape : shapes)
+	{
+		RunShape(pool, shape.m_Name, shape.m_Width, shape.m_Depth, empty, "empty tasks");
+	}
+	for (auto& shape : shapes)
+	{
+		RunShape(pool, shape.m_Name, shape.m_Width, shape.m_Depth, busy, "1us tasks");
+	}
+
+	pool.join();
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "benchmark.h"
+
+#include "framework/components/transform_batch.h"
+
+#include <random>
+
+/// Largest difference allowed between matrices composed by different paths.
+#define TRANSFORM_TOLERANCE 1e-4f
+
+static bool IsNearlyEqual(const Matrix& a, const Matrix& b)
+{
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			if (std::abs(a.m[row][column] - b.m[row][column]) > TRANSFORM_TOLERANCE)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool RunCount(size_t count)
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+	Vector<Vector3> positions;
+	Vector<Quaternion> rotations;
+	Vector<Vector3> scales;
+	TransformArrays arrays;
+	for (size_t i = 0; i < count; i++)
+	{
+		positions.push_back({ position(random), position(random), position(random) });
+		rotations.push_back(Quaternion::CreateFromYawPitchRoll(angle(random), angle(random), angle(random)));
+		scales.push_back({ scale(random), scale(random), scale(random) });
+		arrays.push(positions.back(), rotations.back(), scales.back());
+	}
+
+	const String countName = std::to_string(count / 1000) + "k";
+	Vector<Matrix> simpleMathResults(count);
+	Vector<Matrix> singleResults(count);
+	Vector<Matrix> batchResults(count);
+
+	// How TransformComponent composed its local transform before the batch kernels
+	double simpleMathTime = MeasureMilliseconds([&]() {
+		for (size_t i = 0; i < count; i++)
+		{
+			simpleMathResults[i] = Matrix::CreateScale(scales[i]) * Matrix::CreateFromQuaternion(rotations[i]) * Matrix::CreateTranslation(positions[i]);
+		}
+	});
+	ReportBenchmark("SimpleMath compose " + countName, count, simpleMathTime);
+
+	double singleTime = MeasureMilliseconds([&]() {
+		for (size_t i = 0; i < count; i++)
+		{
+			TransformBatch::Compose(positions[i], rotations[i], scales[i], singleResults[i]);
+		}
+	});
+	ReportBenchmark("Single compose " + countName, count, singleTime);
+
+	double batchTime = MeasureMilliseconds([&]() {
+		TransformBatch::Compose(arrays, batchResults.data());
+	});
+	ReportBenchmark("Batch compose " + countName, count, batchTime);
+
+	// World transforms are the local transforms multiplied by the parent world transforms
+	Vector<Matrix> products(count);
+	double simpleMathMultiplyTime = MeasureMilliseconds([&]() {
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			products[i] = batchResults[i] * batchResults[i + 1];
+		}
+	});
+	ReportBenchmark("SimpleMath multiply " + countName, count - 1, simpleMathMultiplyTime);
+
+	double multiplyTime = MeasureMilliseconds([&]() {
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			TransformBatch::Multiply(batchResults[i], batchResults[i + 1], products[i]);
+		}
+	});
+	ReportBenchmark("Batch multiply " + countName, count - 1, multiplyTime);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!IsNearlyEqual(simpleMathResults[i], singleResults[i]) || !IsNearlyEqual(singleResults[i], batchResults[i]))
+		{
+			printf("Composed transform %zu differs between the SimpleMath, single and batch paths\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+#ifdef ROOTEX_TRANSFORM_SSE
+	printf("Transform benchmark with SSE batch kernels\n");
+#else
+	printf("Transform benchmark with scalar batch kernels\n");
+#endif // ROOTEX_TRANSFORM_SSE
+
+	bool isValid = true;
+	for (size_t count : { (size_t)1000, (size_t)10000, (size_t)100000 })
+	{
+		isValid = RunCount(count) && isValid;
+	}
+	return isValid ? 0 : 1;
+}
@@ -367,9 +367,19 @@ void EditorSystem::drawDefaultUI(float deltaMilliseconds)
 					OS::Execute("start \"\" \"" + OS::GetAbsolutePath("build_fonts.bat").string() + "\"");
 					PRINT("Built fonts");
 				}
+				if (ImGui::MenuItem("Cook Models"))
+				{
+					PRINT("Cooking models in " GAME_ASSET_DIRECTORY "...");
+					ResourceLoader::CookModels(GAME_ASSET_DIRECTORY);
+				}
+				if (ImGui::MenuItem("Build Asset Archive"))
+				{
+					PRINT("Packing " GAME_ASSET_DIRECTORY " into " GAME_ASSET_ARCHIVE "...");
+					AssetArchive::Pack(GAME_ASSET_DIRECTORY, GAME_ASSET_ARCHIVE);
+				}
 				if (ImGui::BeginMenu("Resources"))
 				{
-					for (auto& [data, file] : ResourceLoader::GetResources())
+					for (auto& file : ResourceLoader::GetResources())
 					{
 						ImGui::MenuItem(file->getPath().generic_string().c_str());
 					}
@@ -594,7 +604,7 @@ void EditorSystem::drawDefaultUI(float deltaMilliseconds)
 				ImGui::Text(String("Rootex Engine and Rootex Editor developed by SDSLabs. Built on " + OS::GetBuildDate() + " at " + OS::GetBuildTime() + "\n" + "Source available at https://www.github.com/sdslabs/rootex").c_str());
 
 				static TextResourceFile* license = ResourceLoader::CreateLuaTextResourceFile("LICENSE");
-				ImGui::Text(license->getData()->getRawData()->data());
+				ImGui::TextUnformatted(license->getData()->getReadOnlyData(), license->getData()->getReadOnlyData() + license->getData()->getRawDataByteSize());
 				ImGui::Separator();
 				m_MenuAction = "";
 				ImGui::EndPopup();
@@ -611,7 +621,7 @@ void EditorSystem::drawDefaultUI(float deltaMilliseconds)
 				if (ImGui::BeginPopup(library.string().c_str(), ImGuiWindowFlags_AlwaysAutoResize))
 				{
 					TextResourceFile* license = ResourceLoader::CreateLuaTextResourceFile(library.string() + "/LICENSE");
-					ImGui::Text(license->getData()->getRawData()->data());
+					ImGui::TextUnformatted(license->getData()->getReadOnlyData(), license->getData()->getReadOnlyData() + license->getData()->getRawDataByteSize());
 					m_MenuAction = "";
 					ImGui::EndPopup();
 				}
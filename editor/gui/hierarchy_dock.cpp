@@ -15,7 +15,7 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 	{
 		Ref<Entity> node = hierarchy->getOwner();
 
-		if (ImGui::TreeNodeEx(("##" + std::to_string(node->getID())).c_str(), ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | (hierarchy->getChildren().size() ? ImGuiTreeNodeFlags_None : ImGuiTreeNodeFlags_Leaf)))
+		if (ImGui::TreeNodeEx(("##" + std::to_string(node->getID())).c_str(), ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | (hierarchy->getChildCount() ? ImGuiTreeNodeFlags_None : ImGuiTreeNodeFlags_Leaf)))
 		{
 			ImGui::SameLine();
 
@@ -75,7 +75,7 @@ void HierarchyDock::showHierarchySubTree(HierarchyComponent* hierarchy)
 
 			ImGui::PopStyleColor(1);
 
-			for (auto& child : node->getComponent<HierarchyComponent>()->getChildren())
+			for (HierarchyComponent* child = hierarchy->getFirstChild(); child; child = child->getNextSibling())
 			{
 				showHierarchySubTree(child);
 			}
@@ -136,9 +136,9 @@ void HierarchyDock::draw(float deltaMilliseconds)
 	}
 }
 
-void HierarchyDock::showEntities(const HashMap<EntityID, Ref<Entity>>& entities)
+void HierarchyDock::showEntities(const Vector<Ref<Entity>>& entities)
 {
-	for (auto&& [entityID, entity] : entities)
+	for (auto&& entity : entities)
 	{
 		if (entity->isEditorOnly() == m_IsShowEditorEntities)
 		{
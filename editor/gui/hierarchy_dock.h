@@ -28,7 +28,7 @@ public:
 
 	void draw(float deltaMilliseconds);
 
-	void showEntities(const HashMap<EntityID, Ref<Entity>>& entities);
+	void showEntities(const Vector<Ref<Entity>>& entities);
 
 	HierarchySettings& getSettings() { return m_HierarchySettings; }
 	void setActive(bool enabled) { m_HierarchySettings.m_IsActive = enabled; }
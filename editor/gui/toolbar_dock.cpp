@@ -64,9 +64,16 @@ void ToolbarDock::draw(float deltaMilliseconds)
 
 			if (ImGui::TreeNodeEx("Events", ImGuiTreeNodeFlags_CollapsingHeader))
 			{
-				for (auto&& [eventType, eventHandlers] : EventManager::GetSingleton()->getRegisteredEvents())
-				{				
-					ImGui::Text((eventType + " (" + std::to_string(eventHandlers.size()) + ")").c_str());
+				const DeferredDispatchStats& dispatchStats = EventManager::GetSingleton()->getDeferredDispatchStats();
+				ImGui::Text("Deferred: %u dispatched, %u unhandled, %u carried over in %.3fms", dispatchStats.m_Dispatched, dispatchStats.m_Unhandled, dispatchStats.m_CarriedOver, dispatchStats.m_TimeMs);
+
+				const Vector<Vector<EventFunction>>& registeredEvents = EventManager::GetSingleton()->getRegisteredEvents();
+				for (unsigned int eventType = 0; eventType < registeredEvents.size(); eventType++)
+				{
+					if (!registeredEvents[eventType].empty())
+					{
+						ImGui::Text((EventType::GetName(eventType) + " (" + std::to_string(registeredEvents[eventType].size()) + ")").c_str());
+					}
 				}
 			}
 
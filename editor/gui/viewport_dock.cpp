@@ -68,7 +68,8 @@ void ViewportDock::draw(float deltaMilliseconds)
 						Quaternion rotation;
 						Vector3 scale;
 						Vector3 position;
-						RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Decompose(scale, rotation, position);
+						Matrix cameraTransform = RenderSystem::GetSingleton()->getCamera()->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform();
+						cameraTransform.Decompose(scale, rotation, position);
 						transform->setPosition(position);
 						transform->setRotationQuaternion(rotation);
 					}
@@ -227,7 +228,7 @@ void ViewportDock::draw(float deltaMilliseconds)
 
 				float minimumDistance = D3D11_FLOAT32_MAX;
 				Ref<Entity> selectEntity;
-				for (auto& [entityID, entity] : EntityFactory::GetSingleton()->getEntities())
+				for (auto& entity : EntityFactory::GetSingleton()->getEntities())
 				{
 					if (entity->isEditorOnly())
 					{
@@ -15,6 +15,8 @@
 #include "systems/script_system.h"
 #include "systems/hierarchy_system.h"
 #include "systems/transform_animation_system.h"
+#include "systems/light_system.h"
+#include "systems/audio_position_system.h"
 
 Application* Application::s_Singleton = nullptr;
 
@@ -39,6 +41,14 @@ Application::Application(const String& settingsFile)
 		ERR("Application OS was not initialized");
 	}
 
+#ifndef ROOTEX_EDITOR
+	// The editor works on the loose files so that they can be changed
+	if (OS::IsExists(GAME_ASSET_ARCHIVE))
+	{
+		ResourceLoader::Mount(GAME_ASSET_ARCHIVE);
+	}
+#endif // ROOTEX_EDITOR
+
 	m_ApplicationSettings.reset(new ApplicationSettings(ResourceLoader::CreateTextResourceFile(settingsFile)));
 
 	JSON::json& systemsSettings = m_ApplicationSettings->getJSON()["systems"];
@@ -78,6 +88,9 @@ Application::Application(const String& settingsFile)
 	RenderSystem::GetSingleton();
 	ScriptSystem::GetSingleton();
 	TransformAnimationSystem::GetSingleton();
+	// Created after the systems that move transforms, so that they read this frame's transforms
+	LightSystem::GetSingleton();
+	AudioPositionSystem::GetSingleton();
 
 	auto&& postInitialize = m_ApplicationSettings->find("postInitialize");
 	if (postInitialize != m_ApplicationSettings->end())
@@ -101,20 +114,12 @@ void Application::run()
 	{
 		m_FrameTimer.reset();
 
-		for (auto& [order, systems] : System::GetSystems())
-		{
-			for (auto& system : systems)
-			{
-				if (system->isActive())
-				{
-					system->update(m_FrameTimer.getLastFrameTime());
-				}
-			}
-		}
+		System::UpdateSystems(m_ThreadPool, m_FrameTimer.getLastFrameTime());
 
 		process(m_FrameTimer.getLastFrameTime());
 
 		EventManager::GetSingleton()->dispatchDeferred();
+		ResourceLoader::DispatchCallbacks();
 		m_Window->swapBuffers();
 	}
 
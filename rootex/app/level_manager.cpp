@@ -1,5 +1,6 @@
 #include "level_manager.h"
 
+#include "app/application.h"
 #include "core/input/input_manager.h"
 #include "framework/entity_factory.h"
 #include "framework/systems/hierarchy_system.h"
@@ -76,10 +77,7 @@ void LevelManager::openLevel(const String& levelPath, const Vector<String>& argu
 	Atomic<int> progress;
 	int totalPreloads = preloadLevel(levelPath, progress, openInEditor);
 
-	while (progress.load() != totalPreloads)
-	{
-		;
-	}
+	ResourceLoader::WaitForAsyncLoads();
 
 	PRINT("Preloaded " + std::to_string(totalPreloads) + " new resources");
 
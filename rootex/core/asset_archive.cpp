@@ -0,0 +1,174 @@
+#include "asset_archive.h"
+
+#include <cstring>
+
+static_assert(sizeof(AssetArchive::Header) == 16, "Archive header layout changed");
+static_assert(sizeof(AssetArchive::Entry) == 48, "Archive entry layout changed");
+
+static uint64_t AlignArchiveOffset(uint64_t offset)
+{
+	return (offset + ASSET_ARCHIVE_ALIGNMENT - 1) / ASSET_ARCHIVE_ALIGNMENT * ASSET_ARCHIVE_ALIGNMENT;
+}
+
+uint64_t AssetArchive::HashPath(const String& path)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : path)
+	{
+		hash ^= (unsigned char)c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+Ptr<AssetArchive> AssetArchive::Open(const String& archivePath)
+{
+	Ref<FileMapping> mapping = OS::MapFileContents(archivePath);
+	if (!mapping || mapping->getSize() < sizeof(Header))
+	{
+		ERR("Could not open asset archive: " + archivePath);
+		return nullptr;
+	}
+
+	const Header* header = (const Header*)mapping->getData();
+	if (memcmp(header->m_Magic, ASSET_ARCHIVE_MAGIC, sizeof(header->m_Magic)) != 0 || header->m_Version != ASSET_ARCHIVE_VERSION)
+	{
+		ERR("Not an asset archive or archive version not supported: " + archivePath);
+		return nullptr;
+	}
+
+	uint64_t tableSize = sizeof(Header) + (uint64_t)header->m_EntryCount * sizeof(Entry) + header->m_PathsSize;
+	if (tableSize > mapping->getSize())
+	{
+		ERR("Asset archive is truncated: " + archivePath);
+		return nullptr;
+	}
+
+	Ptr<AssetArchive> archive(new AssetArchive());
+	archive->m_Path = archivePath;
+	archive->m_Mapping = mapping;
+	archive->m_Entries = (const Entry*)(mapping->getData() + sizeof(Header));
+	archive->m_Paths = (const char*)(archive->m_Entries + header->m_EntryCount);
+
+	for (unsigned int i = 0; i < header->m_EntryCount; i++)
+	{
+		const Entry& entry = archive->m_Entries[i];
+		if (entry.m_Offset + entry.m_StoredSize > mapping->getSize() || entry.m_PathOffset + entry.m_PathLength > header->m_PathsSize)
+		{
+			ERR("Asset archive has an entry out of bounds: " + archivePath);
+			return nullptr;
+		}
+		if (entry.m_Compression != Compression::None)
+		{
+			ERR("Asset archive has an entry with unsupported compression: " + archivePath);
+			return nullptr;
+		}
+		archive->m_EntryIndices[entry.m_PathHash] = i;
+	}
+
+	return archive;
+}
+
+const AssetArchive::Entry* AssetArchive::find(const String& path) const
+{
+	auto findIt = m_EntryIndices.find(HashPath(path));
+	if (findIt == m_EntryIndices.end())
+	{
+		return nullptr;
+	}
+
+	const Entry* entry = &m_Entries[findIt->second];
+	if (entry->m_PathLength != path.size() || memcmp(m_Paths + entry->m_PathOffset, path.data(), path.size()) != 0)
+	{
+		return nullptr;
+	}
+	return entry;
+}
+
+bool AssetArchive::Pack(const String& directory, const String& archivePath)
+{
+	Vector<FilePath> files = OS::GetAllFilesInDirectory(directory);
+	// Same assets always make the same archive
+	std::sort(files.begin(), files.end());
+
+	Vector<Entry> entries;
+	Vector<String> entryPaths;
+	String paths;
+	HashMap<uint64_t, String> hashedPaths;
+	for (auto& file : files)
+	{
+		String path = file.lexically_normal().generic_string();
+		if (file.extension() == FilePath(archivePath).extension())
+		{
+			continue;
+		}
+
+		Entry entry = {};
+		entry.m_PathHash = HashPath(path);
+		if (hashedPaths.find(entry.m_PathHash) != hashedPaths.end())
+		{
+			ERR("Could not pack asset archive, paths have the same hash: " + path + ", " + hashedPaths[entry.m_PathHash]);
+			return false;
+		}
+		hashedPaths[entry.m_PathHash] = path;
+
+		entry.m_PathOffset = paths.size();
+		entry.m_PathLength = path.size();
+		entry.m_Size = std::filesystem::file_size(OS::GetAbsolutePath(path));
+		entry.m_StoredSize = entry.m_Size;
+		entry.m_Compression = Compression::None;
+		paths += path;
+
+		entries.push_back(entry);
+		entryPaths.push_back(path);
+	}
+
+	uint64_t offset = AlignArchiveOffset(sizeof(Header) + entries.size() * sizeof(Entry) + paths.size());
+	for (auto& entry : entries)
+	{
+		entry.m_Offset = offset;
+		offset = AlignArchiveOffset(offset + entry.m_StoredSize);
+	}
+
+	Header header;
+	memcpy(header.m_Magic, ASSET_ARCHIVE_MAGIC, sizeof(header.m_Magic));
+	header.m_Version = ASSET_ARCHIVE_VERSION;
+	header.m_EntryCount = entries.size();
+	header.m_PathsSize = paths.size();
+
+	OutputFileStream archive(OS::GetAbsolutePath(archivePath), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!archive)
+	{
+		ERR("Could not create asset archive: " + archivePath);
+		return false;
+	}
+
+	archive.write((const char*)&header, sizeof(header));
+	archive.write((const char*)entries.data(), entries.size() * sizeof(Entry));
+	archive.write(paths.data(), paths.size());
+
+	const char padding[ASSET_ARCHIVE_ALIGNMENT] = {};
+	uint64_t written = sizeof(header) + entries.size() * sizeof(Entry) + paths.size();
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		archive.write(padding, entries[i].m_Offset - written);
+
+		FileBuffer data = OS::LoadFileContents(entryPaths[i]);
+		if (data.size() != entries[i].m_Size)
+		{
+			ERR("File changed while packing asset archive: " + entryPaths[i]);
+			return false;
+		}
+		archive.write(data.data(), data.size());
+		written = entries[i].m_Offset + data.size();
+	}
+
+	if (!archive)
+	{
+		ERR("Could not write asset archive: " + archivePath);
+		return false;
+	}
+
+	PRINT("Packed " + std::to_string(entries.size()) + " files into " + archivePath);
+	return true;
+}
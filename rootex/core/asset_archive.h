@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common/common.h"
+#include "os/os.h"
+
+/// Archive of the game assets that is mounted instead of reading the loose files, in non-editor builds.
+#define GAME_ASSET_ARCHIVE "game/assets.rpak"
+/// Directory packed into GAME_ASSET_ARCHIVE.
+#define GAME_ASSET_DIRECTORY "game/assets"
+/// First bytes of every archive.
+#define ASSET_ARCHIVE_MAGIC "RPAK"
+#define ASSET_ARCHIVE_VERSION 1
+/// Entries start at multiples of this many bytes from the start of the archive.
+#define ASSET_ARCHIVE_ALIGNMENT 16
+
+/// Many asset files packed into a single file, so that they can be read with one open instead of one per file.
+/// Laid out as a Header, the Entry table, the entry paths and then the entry data, each entry aligned to ASSET_ARCHIVE_ALIGNMENT.
+/// The archive is mapped into memory as a whole and entries are read in place.
+class AssetArchive
+{
+public:
+	enum class Compression : uint32_t
+	{
+		/// Stored as is.
+		None = 0
+	};
+
+	struct Header
+	{
+		char m_Magic[4];
+		uint32_t m_Version;
+		uint32_t m_EntryCount;
+		/// Bytes taken by the entry paths, which are stored one after the other without terminators.
+		uint32_t m_PathsSize;
+	};
+
+	struct Entry
+	{
+		/// See AssetArchive::HashPath().
+		uint64_t m_PathHash;
+		/// Offset of the entry data from the start of the archive.
+		uint64_t m_Offset;
+		/// Bytes taken by the entry in the archive.
+		uint64_t m_StoredSize;
+		/// Bytes in the original file.
+		uint64_t m_Size;
+		/// Offset of the path from the start of the entry paths.
+		uint32_t m_PathOffset;
+		uint32_t m_PathLength;
+		Compression m_Compression;
+		uint32_t m_Reserved;
+	};
+
+private:
+	String m_Path;
+	Ref<FileMapping> m_Mapping;
+	const Entry* m_Entries;
+	const char* m_Paths;
+	/// Entry indices by path hash.
+	HashMap<uint64_t, unsigned int> m_EntryIndices;
+
+	AssetArchive() = default;
+
+public:
+	/// 64 bit FNV-1a hash of a root relative path with forward slashes.
+	static uint64_t HashPath(const String& path);
+
+	/// Returns nullptr if the file is not a valid archive.
+	static Ptr<AssetArchive> Open(const String& archivePath);
+	/// Pack every file inside directory, recursively, into a new archive. Paths are stored relative to Rootex root.
+	static bool Pack(const String& directory, const String& archivePath);
+
+	AssetArchive(AssetArchive&) = delete;
+	~AssetArchive() = default;
+
+	/// Returns nullptr if the archive doesn't have the file. path should be normalized and relative to Rootex root.
+	const Entry* find(const String& path) const;
+	const char* getData(const Entry* entry) const { return m_Mapping->getData() + entry->m_Offset; }
+
+	const String& getPath() const { return m_Path; }
+	const Ref<FileMapping>& getMapping() const { return m_Mapping; }
+	unsigned int getEntryCount() const { return m_EntryIndices.size(); }
+};
@@ -11,7 +11,7 @@ void StaticAudioBuffer::initializeBuffers()
 	AL_CHECK(alBufferData(
 	    m_BufferID,
 	    m_AudioFile->getFormat(),
-	    m_AudioFile->getData()->getRawData()->data(),
+	    m_AudioFile->getData()->getReadOnlyData(),
 	    m_AudioFile->getAudioDataSize(),
 	    m_AudioFile->getFrequency()));
 }
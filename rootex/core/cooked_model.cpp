@@ -0,0 +1,198 @@
+#include "cooked_model.h"
+
+#include "os/os.h"
+
+#include <cfloat>
+#include <climits>
+#include <cstring>
+
+static_assert(sizeof(CookedModel::Header) == 48, "Cooked model header layout changed");
+static_assert(sizeof(CookedModel::MaterialEntry) == 16, "Cooked model material entry layout changed");
+static_assert(sizeof(CookedModel::MeshEntry) == 56, "Cooked model mesh entry layout changed");
+
+static uint64_t AlignCookedOffset(uint64_t offset)
+{
+	return (offset + COOKED_MODEL_ALIGNMENT - 1) / COOKED_MODEL_ALIGNMENT * COOKED_MODEL_ALIGNMENT;
+}
+
+String CookedModel::GetCookedPath(const String& modelPath)
+{
+	return modelPath + COOKED_MODEL_EXTENSION;
+}
+
+Ptr<CookedModel> CookedModel::Open(const char* data, size_t size)
+{
+	if (size < sizeof(Header))
+	{
+		return nullptr;
+	}
+
+	const Header* header = (const Header*)data;
+	if (memcmp(header->m_Magic, COOKED_MODEL_MAGIC, sizeof(header->m_Magic)) != 0 || header->m_Version != COOKED_MODEL_VERSION || header->m_VertexStride != sizeof(VertexData))
+	{
+		return nullptr;
+	}
+
+	uint64_t tableSize = sizeof(Header) + (uint64_t)header->m_MaterialCount * sizeof(MaterialEntry) + (uint64_t)header->m_MeshCount * sizeof(MeshEntry) + header->m_PathsSize;
+	if (tableSize > size)
+	{
+		return nullptr;
+	}
+
+	Ptr<CookedModel> model(new CookedModel());
+	model->m_Data = data;
+	model->m_Header = header;
+	model->m_Materials = (const MaterialEntry*)(data + sizeof(Header));
+	model->m_Meshes = (const MeshEntry*)(model->m_Materials + header->m_MaterialCount);
+	model->m_Paths = (const char*)(model->m_Meshes + header->m_MeshCount);
+
+	uint64_t meshCount = 0;
+	for (unsigned int i = 0; i < header->m_MaterialCount; i++)
+	{
+		const MaterialEntry& material = model->m_Materials[i];
+		if ((uint64_t)material.m_PathOffset + material.m_PathLength > header->m_PathsSize)
+		{
+			return nullptr;
+		}
+		meshCount += material.m_MeshCount;
+	}
+	if (meshCount != header->m_MeshCount)
+	{
+		return nullptr;
+	}
+
+	for (unsigned int i = 0; i < header->m_MeshCount; i++)
+	{
+		const MeshEntry& mesh = model->m_Meshes[i];
+		if ((mesh.m_IndexSize != 2 && mesh.m_IndexSize != 4)
+		    || mesh.m_VertexOffset + (uint64_t)mesh.m_VertexCount * sizeof(VertexData) > size
+		    || mesh.m_IndexOffset + (uint64_t)mesh.m_IndexCount * mesh.m_IndexSize > size)
+		{
+			return nullptr;
+		}
+	}
+
+	return model;
+}
+
+bool CookedModel::Write(const String& cookedPath, const Vector<Pair<String, Vector<MeshData>>>& materialMeshes)
+{
+	Header header;
+	memcpy(header.m_Magic, COOKED_MODEL_MAGIC, sizeof(header.m_Magic));
+	header.m_Version = COOKED_MODEL_VERSION;
+	header.m_VertexStride = sizeof(VertexData);
+	header.m_MaterialCount = materialMeshes.size();
+	header.m_MeshCount = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		header.m_BoundsMin[i] = FLT_MAX;
+		header.m_BoundsMax[i] = -FLT_MAX;
+	}
+
+	Vector<MaterialEntry> materials;
+	String paths;
+	for (auto& [materialPath, meshes] : materialMeshes)
+	{
+		MaterialEntry material = {};
+		material.m_PathOffset = paths.size();
+		material.m_PathLength = materialPath.size();
+		material.m_MeshCount = meshes.size();
+		paths += materialPath;
+		materials.push_back(material);
+		header.m_MeshCount += meshes.size();
+	}
+	header.m_PathsSize = paths.size();
+
+	Vector<MeshEntry> meshEntries;
+	Vector<const MeshData*> meshData;
+	uint64_t offset = AlignCookedOffset(sizeof(Header) + materials.size() * sizeof(MaterialEntry) + header.m_MeshCount * sizeof(MeshEntry) + paths.size());
+	for (auto& [materialPath, meshes] : materialMeshes)
+	{
+		for (auto& data : meshes)
+		{
+			MeshEntry mesh = {};
+			mesh.m_VertexCount = data.m_Vertices.size();
+			mesh.m_IndexCount = data.m_Indices.size();
+			// 16 bit indices halve the index data whenever they can address all the vertices
+			mesh.m_IndexSize = data.m_Vertices.size() <= USHRT_MAX ? sizeof(uint16_t) : sizeof(uint32_t);
+
+			for (int i = 0; i < 3; i++)
+			{
+				mesh.m_BoundsMin[i] = FLT_MAX;
+				mesh.m_BoundsMax[i] = -FLT_MAX;
+			}
+			for (auto& vertex : data.m_Vertices)
+			{
+				const float* position = &vertex.m_Position.x;
+				for (int i = 0; i < 3; i++)
+				{
+					mesh.m_BoundsMin[i] = std::min(mesh.m_BoundsMin[i], position[i]);
+					mesh.m_BoundsMax[i] = std::max(mesh.m_BoundsMax[i], position[i]);
+				}
+			}
+			for (int i = 0; i < 3; i++)
+			{
+				header.m_BoundsMin[i] = std::min(header.m_BoundsMin[i], mesh.m_BoundsMin[i]);
+				header.m_BoundsMax[i] = std::max(header.m_BoundsMax[i], mesh.m_BoundsMax[i]);
+			}
+
+			mesh.m_VertexOffset = offset;
+			offset = AlignCookedOffset(offset + (uint64_t)mesh.m_VertexCount * sizeof(VertexData));
+			mesh.m_IndexOffset = offset;
+			offset = AlignCookedOffset(offset + (uint64_t)mesh.m_IndexCount * mesh.m_IndexSize);
+
+			meshEntries.push_back(mesh);
+			meshData.push_back(&data);
+		}
+	}
+
+	OutputFileStream cooked(OS::GetAbsolutePath(cookedPath), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!cooked)
+	{
+		ERR("Could not create cooked model: " + cookedPath);
+		return false;
+	}
+
+	cooked.write((const char*)&header, sizeof(header));
+	cooked.write((const char*)materials.data(), materials.size() * sizeof(MaterialEntry));
+	cooked.write((const char*)meshEntries.data(), meshEntries.size() * sizeof(MeshEntry));
+	cooked.write(paths.data(), paths.size());
+
+	const char padding[COOKED_MODEL_ALIGNMENT] = {};
+	uint64_t written = sizeof(header) + materials.size() * sizeof(MaterialEntry) + meshEntries.size() * sizeof(MeshEntry) + paths.size();
+	for (unsigned int i = 0; i < meshEntries.size(); i++)
+	{
+		const MeshEntry& mesh = meshEntries[i];
+		const MeshData& data = *meshData[i];
+
+		cooked.write(padding, mesh.m_VertexOffset - written);
+		cooked.write((const char*)data.m_Vertices.data(), data.m_Vertices.size() * sizeof(VertexData));
+		written = mesh.m_VertexOffset + data.m_Vertices.size() * sizeof(VertexData);
+
+		cooked.write(padding, mesh.m_IndexOffset - written);
+		if (mesh.m_IndexSize == sizeof(uint16_t))
+		{
+			Vector<uint16_t> indices(data.m_Indices.begin(), data.m_Indices.end());
+			cooked.write((const char*)indices.data(), indices.size() * sizeof(uint16_t));
+		}
+		else
+		{
+			cooked.write((const char*)data.m_Indices.data(), data.m_Indices.size() * sizeof(uint32_t));
+		}
+		written = mesh.m_IndexOffset + (uint64_t)mesh.m_IndexCount * mesh.m_IndexSize;
+	}
+
+	if (!cooked)
+	{
+		ERR("Could not write cooked model: " + cookedPath);
+		return false;
+	}
+	return true;
+}
+
+BoundingBox CookedModel::GetBounds(const MeshEntry& mesh)
+{
+	BoundingBox bounds;
+	BoundingBox::CreateFromPoints(bounds, Vector3(mesh.m_BoundsMin), Vector3(mesh.m_BoundsMax));
+	return bounds;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "common/common.h"
+#include "core/renderer/vertex_data.h"
+
+/// Extension added to a model path to get the path of its cooked model.
+#define COOKED_MODEL_EXTENSION ".rmesh"
+/// First bytes of every cooked model.
+#define COOKED_MODEL_MAGIC "RMSH"
+#define COOKED_MODEL_VERSION 1
+/// Vertex and index data start at multiples of this many bytes from the start of the file.
+#define COOKED_MODEL_ALIGNMENT 16
+
+/// Model already imported, triangulated and split into meshes, stored the way the GPU buffers want it.
+/// Laid out as a Header, the MaterialEntry table, the MeshEntry table, the material paths and then the vertex and index data.
+/// Loading reads the tables in place and hands the vertex and index data to the GPU without converting it.
+class CookedModel
+{
+public:
+	struct Header
+	{
+		char m_Magic[4];
+		uint32_t m_Version;
+		/// sizeof(VertexData) when cooked. Files cooked with a different vertex layout are rejected.
+		uint32_t m_VertexStride;
+		uint32_t m_MaterialCount;
+		uint32_t m_MeshCount;
+		/// Bytes taken by the material paths, which are stored one after the other without terminators.
+		uint32_t m_PathsSize;
+		/// Bounds of all the meshes together.
+		float m_BoundsMin[3];
+		float m_BoundsMax[3];
+	};
+
+	/// Meshes drawn with the same material. Its meshes are the next m_MeshCount meshes after the previous material's.
+	struct MaterialEntry
+	{
+		/// Offset of the material path from the start of the material paths.
+		uint32_t m_PathOffset;
+		uint32_t m_PathLength;
+		uint32_t m_MeshCount;
+		uint32_t m_Reserved;
+	};
+
+	struct MeshEntry
+	{
+		/// Offsets of the vertex and index data from the start of the file.
+		uint64_t m_VertexOffset;
+		uint64_t m_IndexOffset;
+		uint32_t m_VertexCount;
+		uint32_t m_IndexCount;
+		/// 2 for 16 bit indices, 4 for 32 bit indices.
+		uint32_t m_IndexSize;
+		uint32_t m_Reserved;
+		float m_BoundsMin[3];
+		float m_BoundsMax[3];
+	};
+
+	/// Input to CookedModel::Write().
+	struct MeshData
+	{
+		Vector<VertexData> m_Vertices;
+		Vector<unsigned int> m_Indices;
+	};
+
+private:
+	const char* m_Data;
+	const Header* m_Header;
+	const MaterialEntry* m_Materials;
+	const MeshEntry* m_Meshes;
+	const char* m_Paths;
+
+	CookedModel() = default;
+
+public:
+	/// Path of the cooked model made for modelPath.
+	static String GetCookedPath(const String& modelPath);
+
+	/// Returns nullptr if the data is not a valid cooked model. The data should outlive the returned object.
+	static Ptr<CookedModel> Open(const char* data, size_t size);
+	/// Write meshes grouped by material path to cookedPath.
+	static bool Write(const String& cookedPath, const Vector<Pair<String, Vector<MeshData>>>& materialMeshes);
+
+	CookedModel(CookedModel&) = delete;
+	~CookedModel() = default;
+
+	unsigned int getMaterialCount() const { return m_Header->m_MaterialCount; }
+	const MaterialEntry& getMaterial(unsigned int index) const { return m_Materials[index]; }
+	String getMaterialPath(const MaterialEntry& material) const { return String(m_Paths + material.m_PathOffset, material.m_PathLength); }
+
+	unsigned int getMeshCount() const { return m_Header->m_MeshCount; }
+	const MeshEntry& getMesh(unsigned int index) const { return m_Meshes[index]; }
+	const VertexData* getVertices(const MeshEntry& mesh) const { return (const VertexData*)(m_Data + mesh.m_VertexOffset); }
+	const char* getIndices(const MeshEntry& mesh) const { return m_Data + mesh.m_IndexOffset; }
+
+	static BoundingBox GetBounds(const MeshEntry& mesh);
+};
@@ -1,10 +1,81 @@
 #include "event.h"
 
+#include <deque>
+#include <mutex>
+
+/// Storage for all interned event type names.
+struct EventTypeTable
+{
+	std::mutex m_Mutex;
+	HashMap<String, unsigned int> m_IDs;
+	/// Deque so that references to names stay valid as more names are interned.
+	std::deque<String> m_Names;
+
+	EventTypeTable()
+	{
+		// The empty name always has ID 0
+		m_Names.push_back("");
+		m_IDs[""] = 0;
+	}
+};
+
+static EventTypeTable& GetEventTypeTable()
+{
+	static EventTypeTable table;
+	return table;
+}
+
+unsigned int EventType::Intern(const String& name)
+{
+	EventTypeTable& table = GetEventTypeTable();
+	std::lock_guard<std::mutex> lock(table.m_Mutex);
+
+	auto&& findIt = table.m_IDs.find(name);
+	if (findIt != table.m_IDs.end())
+	{
+		return findIt->second;
+	}
+
+	unsigned int ID = table.m_Names.size();
+	table.m_Names.push_back(name);
+	table.m_IDs[name] = ID;
+	return ID;
+}
+
+const String& EventType::GetName(unsigned int ID)
+{
+	EventTypeTable& table = GetEventTypeTable();
+	std::lock_guard<std::mutex> lock(table.m_Mutex);
+	return table.m_Names.at(ID);
+}
+
+unsigned int EventType::GetCount()
+{
+	EventTypeTable& table = GetEventTypeTable();
+	std::lock_guard<std::mutex> lock(table.m_Mutex);
+	return table.m_Names.size();
+}
+
+EventType::EventType()
+    : m_ID(0)
+{
+}
+
+EventType::EventType(const String& name)
+    : m_ID(Intern(name))
+{
+}
+
+EventType::EventType(const char* name)
+    : m_ID(Intern(name))
+{
+}
+
 void Event::RegisterAPI(sol::table& rootex)
 {
-	sol::usertype<Event> event = rootex.new_usertype<Event>("Event", sol::constructors<Event(const String&, const Event::Type, const Variant)>());
+	sol::usertype<Event> event = rootex.new_usertype<Event>("Event", sol::factories([](const String& name, const String& type, const Variant& data) { return Ref<Event>(new Event(name, type, data)); }));
 	event["getName"] = &Event::getName;
-	event["getType"] = &Event::getType;
+	event["getType"] = [](const Event* e) { return e->getType().getName(); };
 	event["getData"] = &Event::getData;
 }
 
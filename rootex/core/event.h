@@ -3,12 +3,39 @@
 #include "common/common.h"
 #include "entity.h"
 
+/// Interned handle to the name of an event type. Event types with the same name share the same ID.
+/// Constructing one from a name looks the name up once, so keep handles around on hot paths.
+class EventType
+{
+	unsigned int m_ID;
+
+public:
+	/// Returns the ID of the name, interning it if it is seen for the first time. Safe to call from any thread.
+	static unsigned int Intern(const String& name);
+	static const String& GetName(unsigned int ID);
+	/// Number of event type names interned so far. IDs are always less than this.
+	static unsigned int GetCount();
+
+	/// The event type with an empty name.
+	EventType();
+	EventType(const String& name);
+	EventType(const char* name);
+	EventType(const EventType&) = default;
+	~EventType() = default;
+
+	unsigned int getID() const { return m_ID; }
+	const String& getName() const { return GetName(m_ID); }
+
+	bool operator==(const EventType& other) const { return m_ID == other.m_ID; }
+	bool operator!=(const EventType& other) const { return m_ID != other.m_ID; }
+};
+
 /// An Event that is sent out by EventManager.
 class Event
 {
 public:
-	/// String defining the type of the event.
-	typedef String Type;
+	/// Interned name defining the type of the event.
+	typedef EventType Type;
 
 private:
 	Type m_Type;
@@ -1,10 +1,47 @@
 #include "event_manager.h"
 
 #include "entity.h"
+#include "os/timer.h"
+
+EventQueue::EventQueue()
+    : m_Front(0)
+    , m_Size(0)
+{
+	m_Events.resize(64);
+}
+
+void EventQueue::grow()
+{
+	Vector<Ref<Event>> events(m_Events.size() * 2);
+	for (size_t i = 0; i < m_Size; i++)
+	{
+		events[i] = std::move(m_Events[(m_Front + i) & (m_Events.size() - 1)]);
+	}
+	m_Events.swap(events);
+	m_Front = 0;
+}
+
+void EventQueue::push(Ref<Event>&& event)
+{
+	if (m_Size == m_Events.size())
+	{
+		grow();
+	}
+	m_Events[(m_Front + m_Size) & (m_Events.size() - 1)] = std::move(event);
+	m_Size++;
+}
+
+Ref<Event> EventQueue::pop()
+{
+	Ref<Event> event = std::move(m_Events[m_Front]);
+	m_Front = (m_Front + 1) & (m_Events.size() - 1);
+	m_Size--;
+	return event;
+}
 
 EventManager::EventManager()
+    : m_DispatchDepth(0)
 {
-	m_ActiveQueue = 0;
 }
 
 EventManager ::~EventManager() 
@@ -27,78 +64,156 @@ EventManager* EventManager::GetSingleton()
 	return &singleton;
 }
 
-bool EventManager::addEvent(const Event::Type& event)
+const Vector<EventFunction>* EventManager::findListeners(const Event::Type& type) const
 {
-	if (m_EventListeners.find(event) == m_EventListeners.end())
+	if (type.getID() < m_EventListeners.size() && !m_EventListeners[type.getID()].empty())
 	{
-		m_EventListeners[event] = {};
-		return true;
+		return &m_EventListeners[type.getID()];
 	}
-	return false;
+	return nullptr;
 }
 
-void EventManager::removeEvent(const Event::Type& event)
+void EventManager::beginDispatch()
 {
-	m_EventListeners.erase(event);
+	m_DispatchDepth++;
 }
 
-Variant EventManager::returnCall(const Event& event)
+void EventManager::endDispatch()
 {
-	auto&& findIt = m_EventListeners.find(event.getType());
+	m_DispatchDepth--;
+	if (m_DispatchDepth == 0 && !m_PendingListenerChanges.empty())
+	{
+		Vector<Function<void()>> changes;
+		changes.swap(m_PendingListenerChanges);
+		for (auto& change : changes)
+		{
+			change();
+		}
+	}
+}
 
-	if (findIt != m_EventListeners.end())
+void EventManager::dispatch(const Event& event)
+{
+	const Vector<EventFunction>* eventListeners = findListeners(event.getType());
+	if (eventListeners)
 	{
-		return findIt->second.front()(&event);
+		beginDispatch();
+		for (const EventFunction& listener : *eventListeners)
+		{
+			listener(&event);
+		}
+		endDispatch();
 	}
-	return false;
 }
 
-Variant EventManager::returnCall(const String& eventName, const Event::Type& eventType, const Variant& data)
+unsigned int EventManager::NextPayloadTypeID()
 {
-	Event event(eventName, eventType, data);
-	return returnCall(event);
+	static Atomic<unsigned int> count(0);
+	return count++;
 }
 
-void EventManager::call(const Event& event)
+void EventManager::addTypedListener(unsigned int payloadTypeID, const TypedEventFunction& listener)
 {
-	bool processed = false;
-	auto&& findIt = m_EventListeners.find(event.getType());
+	if (m_DispatchDepth > 0)
+	{
+		m_PendingListenerChanges.push_back([this, payloadTypeID, listener]() { addTypedListener(payloadTypeID, listener); });
+		return;
+	}
+
+	if (payloadTypeID >= m_TypedEventListeners.size())
+	{
+		m_TypedEventListeners.resize(payloadTypeID + 1);
+	}
+	m_TypedEventListeners[payloadTypeID].push_back(listener);
+}
 
-	if (findIt != m_EventListeners.end())
+void EventManager::dispatchTyped(unsigned int payloadTypeID, const void* payload)
+{
+	if (payloadTypeID < m_TypedEventListeners.size())
 	{
-		const Vector<EventFunction>& eventListenerList = findIt->second;
-		for (auto it = eventListenerList.begin(); it != eventListenerList.end(); ++it)
+		beginDispatch();
+		for (const TypedEventFunction& listener : m_TypedEventListeners[payloadTypeID])
 		{
-			EventFunction listener = *it;
- 			listener(&event);
-			processed = true;
+			listener(payload);
 		}
+		endDispatch();
 	}
 }
 
-void EventManager::call(const String& eventName, const Event::Type& eventType, const Variant& data)
+bool EventManager::addEvent(const Event::Type& event)
 {
-	Event event(eventName, eventType, data);
-	call(event);
+	if (event.getID() >= m_IsEventAdded.size())
+	{
+		m_IsEventAdded.resize(event.getID() + 1, false);
+	}
+	bool isNew = !m_IsEventAdded[event.getID()];
+	m_IsEventAdded[event.getID()] = true;
+
+	if (m_DispatchDepth > 0)
+	{
+		m_PendingListenerChanges.push_back([this, event]() { addEvent(event); });
+		return isNew;
+	}
+
+	if (event.getID() >= m_EventListeners.size())
+	{
+		m_EventListeners.resize(event.getID() + 1);
+	}
+	return isNew;
 }
 
-void EventManager::deferredCall(Ref<Event> event)
+void EventManager::removeEvent(const Event::Type& event)
 {
-	if (!(m_ActiveQueue >= 0 && m_ActiveQueue < EVENTMANAGER_NUM_QUEUES))
+	if (event.getID() < m_IsEventAdded.size())
 	{
-		WARN("Event left unhandled: " + event->getName());
+		m_IsEventAdded[event.getID()] = false;
 	}
 
-	auto&& findIt = m_EventListeners.find(event->getType());
-	if (findIt != m_EventListeners.end())
+	if (m_DispatchDepth > 0)
 	{
-		m_Queues[m_ActiveQueue].push_back(event);
+		m_PendingListenerChanges.push_back([this, event]() { removeEvent(event); });
 		return;
 	}
-	else
+
+	if (event.getID() < m_EventListeners.size())
+	{
+		m_EventListeners[event.getID()].clear();
+	}
+}
+
+Variant EventManager::returnCall(const Event& event)
+{
+	const Vector<EventFunction>* eventListeners = findListeners(event.getType());
+	if (eventListeners)
 	{
-		WARN("Event left unhandled: " + event->getName());
+		beginDispatch();
+		Variant result = eventListeners->front()(&event);
+		endDispatch();
+		return result;
 	}
+	return false;
+}
+
+Variant EventManager::returnCall(const String& eventName, const Event::Type& eventType, const Variant& data)
+{
+	Event event(eventName, eventType, data);
+	return returnCall(event);
+}
+
+void EventManager::call(const Event& event)
+{
+	dispatch(event);
+}
+
+void EventManager::call(const String& eventName, const Event::Type& eventType, const Variant& data)
+{
+	Event event(eventName, eventType, data);
+	call(event);
+}
+
+void EventManager::deferredCall(Ref<Event> event)
+{
+	m_DeferredEvents.push(std::move(event));
 }
 
 void EventManager::deferredCall(const String& eventName, const Event::Type& eventType, const Variant& data)
@@ -109,52 +224,52 @@ void EventManager::deferredCall(const String& eventName, const Event::Type& even
 
 bool EventManager::dispatchDeferred(unsigned long maxMillis)
 {
-	int queueToProcess = m_ActiveQueue;
-	m_ActiveQueue = (m_ActiveQueue + 1) % EVENTMANAGER_NUM_QUEUES;
-	m_Queues[m_ActiveQueue].clear();
+	StopTimer timer;
+	m_DispatchStats = {};
 
-	while (!m_Queues[queueToProcess].empty())
+	// Events deferred while dispatching are left for the next frame
+	m_DeferredEvents.popAll(m_IncomingEvents);
+	for (auto& event : m_IncomingEvents)
 	{
-		Ref<Event> event = m_Queues[queueToProcess].front();
-		m_Queues[queueToProcess].erase(m_Queues[queueToProcess].begin());
-		const Event::Type eventType = event->getType();
+		m_PendingEvents.push(std::move(event));
+	}
+	m_IncomingEvents.clear();
 
-		auto findIt = m_EventListeners.find(eventType);
-		if (findIt != m_EventListeners.end())
+	while (!m_PendingEvents.isEmpty())
+	{
+		// Dispatch at least one event per call so that events always make progress
+		if (maxMillis != Infinite && m_DispatchStats.m_Dispatched > 0 && timer.getTimeMs() >= maxMillis)
 		{
-			const Vector<EventFunction>& eventListeners = findIt->second;
-			for (auto it = eventListeners.begin(); it != eventListeners.end(); ++it)
-			{
-				EventFunction listener = *it;
-				listener(event.get());
-			}
+			break;
 		}
 
-		// check to see if time ran out
-		// currMs = GetTickCount();
-		// if (maxMillis != IEventManager::kINFINITE && currMs >= maxMs)
-		// {
-		//  	WARN("Aborting event processing; time ran out");
-		//  	break;
-		// }
-	}
-	// If we couldn't process all of the events, push the remaining events to
-	// the new active queue.
-	bool queueFlushed = (m_Queues[queueToProcess].empty());
-	if (!queueFlushed)
-	{
-		while (!m_Queues[queueToProcess].empty())
+		Ref<Event> event = m_PendingEvents.pop();
+		if (findListeners(event->getType()))
+		{
+			dispatch(*event);
+		}
+		else
 		{
-			Ref<Event> pEvent = m_Queues[queueToProcess].back();
-			m_Queues[queueToProcess].pop_back();
-			m_Queues[m_ActiveQueue].insert(m_Queues[m_ActiveQueue].begin(), pEvent);
+			WARN("Event left unhandled: " + event->getName());
+			m_DispatchStats.m_Unhandled++;
 		}
+		m_DispatchStats.m_Dispatched++;
 	}
-	return queueFlushed;
+
+	m_DispatchStats.m_CarriedOver = m_PendingEvents.size();
+	m_DispatchStats.m_TimeMs = timer.getTimeMs();
+	return m_PendingEvents.isEmpty();
 }
 
 bool EventManager::addListener(const Event::Type& type, EventFunction instance)
 {
-	m_EventListeners[type].push_back(instance);
+	addEvent(type);
+	if (m_DispatchDepth > 0)
+	{
+		m_PendingListenerChanges.push_back([this, type, instance]() { addListener(type, instance); });
+		return true;
+	}
+
+	m_EventListeners[type.getID()].push_back(instance);
 	return true;
 }
@@ -2,28 +2,95 @@
 
 #include "common/common.h"
 #include "event.h"
+#include "os/thread.h"
 
 /// Bind a member function of a class to an event.
 #define BIND_EVENT_FUNCTION(stringEventType, function) EventManager::GetSingleton()->addListener(stringEventType, function)
 /// Bind a global function to an event.
 #define BIND_EVENT_MEMBER_FUNCTION(stringEventType, classFunction) EventManager::GetSingleton()->addListener(stringEventType, [this](const Event* event) -> Variant { return this->classFunction(event); })
-
-/// Number of event queues used to organise events in EventManager.
-const unsigned int EVENTMANAGER_NUM_QUEUES = 2;
+/// Bind a member function of a class to a typed event carrying a payload of PayloadType.
+#define BIND_TYPED_EVENT_MEMBER_FUNCTION(PayloadType, classFunction) EventManager::GetSingleton()->addListener<PayloadType>([this](const PayloadType& payload) { this->classFunction(payload); })
 
 /// Function object for storing a function that handles an event.
 typedef Function<Variant(const Event*)> EventFunction;
+/// Function object for storing a function that handles a typed event, with the payload type erased.
+typedef Function<void(const void*)> TypedEventFunction;
+
+/// Growable ring buffer of events. Pushing at the back and popping from the front are O(1).
+class EventQueue
+{
+	/// Capacity is always a power of 2.
+	Vector<Ref<Event>> m_Events;
+	size_t m_Front;
+	size_t m_Size;
+
+	void grow();
+
+public:
+	EventQueue();
+	EventQueue(EventQueue&) = delete;
+	~EventQueue() = default;
+
+	void push(Ref<Event>&& event);
+	/// Undefined if empty.
+	Ref<Event> pop();
+
+	size_t size() const { return m_Size; }
+	bool isEmpty() const { return m_Size == 0; }
+};
+
+/// Statistics of a single EventManager::dispatchDeferred() call.
+struct DeferredDispatchStats
+{
+	unsigned int m_Dispatched = 0;
+	/// Dispatched events that had no listeners.
+	unsigned int m_Unhandled = 0;
+	/// Events carried over to the next call because the time budget ran out.
+	unsigned int m_CarriedOver = 0;
+	float m_TimeMs = 0.0f;
+};
 
 /// An Event dispatcher and registrar that also allows looking up registered events.
 class EventManager
 {
-	HashMap<Event::Type, Vector<EventFunction>> m_EventListeners;
-	Vector<Ref<Event>> m_Queues[EVENTMANAGER_NUM_QUEUES];
-	unsigned int m_ActiveQueue;
+	/// Listeners of each event type, indexed by the event type ID.
+	Vector<Vector<EventFunction>> m_EventListeners;
+	/// Whether each event type is added and not removed since, indexed by the event type ID.
+	/// Kept apart from the listener lists so that it can change while listeners run.
+	Vector<bool> m_IsEventAdded;
+	/// Listeners of each typed event, indexed by the payload type ID.
+	Vector<Vector<TypedEventFunction>> m_TypedEventListeners;
+	/// Deferred events posted from any thread.
+	ConcurrentQueue<Ref<Event>> m_DeferredEvents;
+	/// Scratch buffer for moving events out of the concurrent queue.
+	Vector<Ref<Event>> m_IncomingEvents;
+	/// Deferred events yet to be dispatched, including the ones carried over from earlier frames.
+	EventQueue m_PendingEvents;
+	DeferredDispatchStats m_DispatchStats;
+
+	/// Number of listener calls in progress. Listener lists stay untouched while this is non-zero.
+	int m_DispatchDepth;
+	/// Changes to listener lists requested from inside listeners, applied once the outermost dispatch ends.
+	Vector<Function<void()>> m_PendingListenerChanges;
 
 	EventManager();
 	~EventManager();
 
+	/// Returns nullptr if the event type has no listeners.
+	const Vector<EventFunction>* findListeners(const Event::Type& type) const;
+	/// Call all listeners of the event.
+	void dispatch(const Event& event);
+	void beginDispatch();
+	void endDispatch();
+
+	static unsigned int NextPayloadTypeID();
+	/// Returns a unique ID for each payload type, assigned on first use.
+	template <class T>
+	static unsigned int GetPayloadTypeID();
+
+	void addTypedListener(unsigned int payloadTypeID, const TypedEventFunction& listener);
+	void dispatchTyped(unsigned int payloadTypeID, const void* payload);
+
 public:
 	static void RegisterAPI(sol::table& rootex);
 	static EventManager* GetSingleton();
@@ -33,7 +100,7 @@ public:
 		Infinite = 0xffffffff
 	};
 
-	/// Add an event. Returns false if it already exists.
+	/// Add an event. Returns true if the event was newly added, false if it was already added and not removed since.
 	bool addEvent(const Event::Type& event);
 	void removeEvent(const Event::Type& event);
 	/// Add an event handler for an event. Creates a new event is not already existing. Returns false if the handler is already added.
@@ -43,11 +110,42 @@ public:
 	Variant returnCall(const String& eventName, const Event::Type& eventType, const Variant& data);
 	void call(const Event& event);
 	void call(const String& eventName, const Event::Type& eventType, const Variant& data);
-	/// Publish an event that gets evaluated the end of the current frame.
+	/// Publish an event that gets evaluated the end of the current frame. Safe to call from any thread.
 	void deferredCall(Ref<Event> event);
 	void deferredCall(const String& eventName, const Event::Type& eventType, const Variant& data);
-	/// Dispatch deferred events collected so far.
+	/// Add a handler for typed events carrying a payload of type T.
+	template <class T>
+	void addListener(const Function<void(const T&)>& listener);
+	/// Publish a typed event. The payload is handed to the listeners by reference, without any allocation or copies.
+	/// Typed events are meant for small engine-side payloads. Use Variant events for events that Lua needs to see.
+	template <class T>
+	void call(const T& payload);
+
+	/// Dispatch deferred events collected so far. Call only from the main thread.
+	/// Events left over after maxMillis are dispatched in the next call. Returns true if all events were dispatched.
 	bool dispatchDeferred(unsigned long maxMillis = Infinite);
 
-	const HashMap<Event::Type, Vector<EventFunction>>& getRegisteredEvents() const { return m_EventListeners; }
+	/// Listeners of all event types, indexed by the event type ID. Use EventType::GetName() to find the name of an ID.
+	const Vector<Vector<EventFunction>>& getRegisteredEvents() const { return m_EventListeners; }
+	/// Statistics of the last dispatchDeferred() call.
+	const DeferredDispatchStats& getDeferredDispatchStats() const { return m_DispatchStats; }
 };
+
+template <class T>
+inline unsigned int EventManager::GetPayloadTypeID()
+{
+	static const unsigned int ID = NextPayloadTypeID();
+	return ID;
+}
+
+template <class T>
+inline void EventManager::addListener(const Function<void(const T&)>& listener)
+{
+	addTypedListener(GetPayloadTypeID<T>(), [listener](const void* payload) { listener(*(const T*)payload); });
+}
+
+template <class T>
+inline void EventManager::call(const T& payload)
+{
+	dispatchTyped(GetPayloadTypeID<T>(), &payload);
+}
@@ -88,7 +88,7 @@ void InputManager::setScheme(const String& schemeName)
 	m_CurrentInputScheme = schemeName;
 }
 
-void InputManager::mapBool(const Event::Type& action, Device device, DeviceButtonID button)
+void InputManager::mapBool(const String& action, Device device, DeviceButtonID button)
 {
 	m_InputEventNameIDs[action] = getNextID();
 	m_InputEventIDNames[m_InputEventNameIDs[action]] = action;
@@ -98,7 +98,7 @@ void InputManager::mapBool(const Event::Type& action, Device device, DeviceButto
 	}
 }
 
-void InputManager::mapFloat(const Event::Type& action, Device device, DeviceButtonID button)
+void InputManager::mapFloat(const String& action, Device device, DeviceButtonID button)
 {
 	m_InputEventNameIDs[action] = getNextID();
 	m_InputEventIDNames[m_InputEventNameIDs[action]] = action;
@@ -108,12 +108,12 @@ void InputManager::mapFloat(const Event::Type& action, Device device, DeviceButt
 	}
 }
 
-void InputManager::unmap(const Event::Type& action)
+void InputManager::unmap(const String& action)
 {
 	m_GainputMap.Unmap(m_InputEventNameIDs[action]);
 }
 
-bool InputManager::isPressed(const Event::Type& action)
+bool InputManager::isPressed(const String& action)
 {
 	if (m_IsEnabled)
 	{
@@ -122,7 +122,7 @@ bool InputManager::isPressed(const Event::Type& action)
 	return false;
 }
 
-bool InputManager::wasPressed(const Event::Type& action)
+bool InputManager::wasPressed(const String& action)
 {
 	if (m_IsEnabled)
 	{
@@ -131,7 +131,7 @@ bool InputManager::wasPressed(const Event::Type& action)
 	return false;
 }
 
-float InputManager::getFloat(const Event::Type& action)
+float InputManager::getFloat(const String& action)
 {
 	if (m_IsEnabled)
 	{
@@ -140,7 +140,7 @@ float InputManager::getFloat(const Event::Type& action)
 	return 0;
 }
 
-float InputManager::getFloatDelta(const Event::Type& action)
+float InputManager::getFloatDelta(const String& action)
 {
 	if (m_IsEnabled)
 	{
@@ -59,7 +59,7 @@ class InputManager
 	String m_CurrentInputScheme;
 
 	HashMap<unsigned int, Event::Type> m_InputEventIDNames;
-	HashMap<Event::Type, unsigned int> m_InputEventNameIDs;
+	HashMap<String, unsigned int> m_InputEventNameIDs;
 
 	unsigned int m_Width;
 	unsigned int m_Height;
@@ -87,16 +87,16 @@ public:
 	void setScheme(const String& schemeName);
 
 	/// Bind an event to a button on a device.
-	void mapBool(const Event::Type& action, Device device, DeviceButtonID button);
+	void mapBool(const String& action, Device device, DeviceButtonID button);
 	/// Bind an event to a float on a device.
-	void mapFloat(const Event::Type& action, Device device, DeviceButtonID button);
+	void mapFloat(const String& action, Device device, DeviceButtonID button);
 
-	void unmap(const Event::Type& action);
+	void unmap(const String& action);
 
-	bool isPressed(const Event::Type& action);
-	bool wasPressed(const Event::Type& action);
-	float getFloat(const Event::Type& action);
-	float getFloatDelta(const Event::Type& action);
+	bool isPressed(const String& action);
+	bool wasPressed(const String& action);
+	float getFloat(const String& action);
+	float getFloatDelta(const String& action);
 
 	void update();
 	void setDisplaySize(const Vector2& newSize);
@@ -15,6 +15,9 @@ protected:
 public:
 	IndexBuffer(const Vector<unsigned short>& indices);
 	IndexBuffer(const Vector<int>& indices);
+	/// Indices are read straight from the pointers, so they can point into a mapped file.
+	IndexBuffer(const unsigned short* indices, unsigned int count);
+	IndexBuffer(const unsigned int* indices, unsigned int count);
 	~IndexBuffer() = default;
 
 	void bind() const;
@@ -3,6 +3,7 @@
 #include "core/resource_loader.h"
 
 MaterialLibrary::MaterialMap MaterialLibrary::s_Materials;
+std::recursive_mutex MaterialLibrary::s_MaterialsMutex;
 const String MaterialLibrary::s_DefaultMaterialPath = "rootex/assets/materials/default.rmat";
 
 MaterialLibrary::MaterialDatabase MaterialLibrary::s_MaterialDatabase = {
@@ -18,6 +19,7 @@ void MaterialLibrary::PopulateMaterials(const String& path)
 		{
 			TextResourceFile* materialResourceFile = ResourceLoader::CreateTextResourceFile(materialFile.generic_string());
 			const JSON::json& materialJSON = JSON::json::parse(materialResourceFile->getString());
+			std::lock_guard<std::recursive_mutex> lock(s_MaterialsMutex);
 			s_Materials[materialFile.generic_string()] = { (String)materialJSON["type"], {} };
 		}
 	}
@@ -37,6 +39,8 @@ void MaterialLibrary::LoadMaterials()
 
 Ref<Material> MaterialLibrary::GetMaterial(const String& materialPath)
 {
+	// Held while the material is created, so that threads asking for the same material share one instance
+	std::lock_guard<std::recursive_mutex> lock(s_MaterialsMutex);
 	if (s_Materials.find(materialPath) == s_Materials.end())
 	{
 		WARN("Material file not found, returning default material instead of: " + materialPath);
@@ -62,6 +66,7 @@ Ref<Material> MaterialLibrary::GetMaterial(const String& materialPath)
 
 Ref<Material> MaterialLibrary::GetDefaultMaterial()
 {
+	std::lock_guard<std::recursive_mutex> lock(s_MaterialsMutex);
 	if (Ref<Material> lockedMaterial = s_Materials[s_DefaultMaterialPath].second.lock())
 	{
 		return lockedMaterial;
@@ -77,6 +82,7 @@ Ref<Material> MaterialLibrary::GetDefaultMaterial()
 
 void MaterialLibrary::SaveAll()
 {
+	std::lock_guard<std::recursive_mutex> lock(s_MaterialsMutex);
 	for (auto& [materialPath, materialInfo] : s_Materials)
 	{
 		if (IsDefault(materialPath))
@@ -99,6 +105,7 @@ void MaterialLibrary::CreateNewMaterialFile(const String& materialPath, const St
 		return;
 	}
 
+	std::lock_guard<std::recursive_mutex> lock(s_MaterialsMutex);
 	if (s_Materials.find(materialPath) == s_Materials.end())
 	{
 		if (!OS::IsExists(materialPath))
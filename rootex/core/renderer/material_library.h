@@ -2,6 +2,8 @@
 
 #include "common/common.h"
 
+#include <mutex>
+
 #include "materials/basic_material.h"
 #include "materials/sky_material.h"
 
@@ -16,6 +18,8 @@ private:
 	typedef HashMap<String, Pair<MaterialDefaultCreator, MaterialCreator>> MaterialDatabase;
 
 	static MaterialMap s_Materials;
+	/// Guards s_Materials. Models loading on worker threads fetch their materials. Recursive because the getters fall back to the default material.
+	static std::recursive_mutex s_MaterialsMutex;
 	static MaterialDatabase s_MaterialDatabase;
 	static void PopulateMaterials(const String& path);
 
@@ -31,6 +35,7 @@ public:
 
 	static Ref<Material> GetMaterial(const String& materialPath);
 	static Ref<Material> GetDefaultMaterial();
+	/// Not guarded, use on the main thread while no resources are loading asynchronously.
 	static MaterialMap& GetAllMaterials() { return s_Materials; };
 	static MaterialDatabase& GetMaterialDatabase() { return s_MaterialDatabase; };
 };
@@ -346,9 +346,9 @@ void RenderingDevice::createSwapChainAndRTs(int width, int height, bool MSAA, co
 	GFX_ERR_CHECK(m_Device->CreateShaderResourceView(m_OffScreenRTTextureResolved.Get(), &shaderResourceViewDesc, &m_OffScreenRTSRVResolved));
 }
 
-Ref<DirectX::SpriteFont> RenderingDevice::createFont(FileBuffer* fontFileBuffer)
+Ref<DirectX::SpriteFont> RenderingDevice::createFont(const char* fontFileData, size_t size)
 {
-	return Ref<DirectX::SpriteFont>(new DirectX::SpriteFont(m_Device.Get(), (const uint8_t*)fontFileBuffer->data(), fontFileBuffer->size()));
+	return Ref<DirectX::SpriteFont>(new DirectX::SpriteFont(m_Device.Get(), (const uint8_t*)fontFileData, size));
 }
 
 Microsoft::WRL::ComPtr<ID3DBlob> RenderingDevice::createBlob(LPCWSTR path)
@@ -474,7 +474,7 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createTexture(
 	Microsoft::WRL::ComPtr<ID3D11Resource> textureResource;
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> textureView;
 
-	if (FAILED(DirectX::CreateWICTextureFromMemoryEx(m_Device.Get(), (const uint8_t*)imageRes->getData()->getRawData()->data(), (size_t)imageRes->getData()->getRawDataByteSize(), 0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, DirectX::WIC_LOADER_IGNORE_SRGB | DirectX::WIC_LOADER_FORCE_RGBA32, textureResource.GetAddressOf(), textureView.GetAddressOf())))
+	if (FAILED(DirectX::CreateWICTextureFromMemoryEx(m_Device.Get(), (const uint8_t*)imageRes->getData()->getReadOnlyData(), (size_t)imageRes->getData()->getRawDataByteSize(), 0, D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, DirectX::WIC_LOADER_IGNORE_SRGB | DirectX::WIC_LOADER_FORCE_RGBA32, textureResource.GetAddressOf(), textureView.GetAddressOf())))
 	{
 		ERR("Could not create texture: " + imageRes->getPath().generic_string());
 	}
@@ -489,7 +489,7 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> RenderingDevice::createDDSTextu
 
 	if (FAILED(DirectX::CreateDDSTextureFromMemoryEx(
 		m_Device.Get(),
-		(const uint8_t*)imageRes->getData()->getRawData()->data(),
+		(const uint8_t*)imageRes->getData()->getReadOnlyData(),
 	        imageRes->getData()->getRawDataByteSize(), imageRes->getData()->getRawDataByteSize(), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, D3D11_RESOURCE_MISC_TEXTURECUBE, false, &textureResource, &textureView)))
 	{
 		ERR("Could not load DDS image: " + imageRes->getPath().generic_string());
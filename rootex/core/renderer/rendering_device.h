@@ -95,7 +95,7 @@ public:
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> createVS(ID3DBlob* blob);
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> createVL(ID3DBlob* vertexShaderBlob, const D3D11_INPUT_ELEMENT_DESC* ied, UINT size);
 
-	Ref<DirectX::SpriteFont> createFont(FileBuffer* fontFileBuffer);
+	Ref<DirectX::SpriteFont> createFont(const char* fontFileData, size_t size);
 	/// To hold shader blobs loaded from the compiled shader files
 	Microsoft::WRL::ComPtr<ID3DBlob> createBlob(LPCWSTR path);
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createTexture(ImageResourceFile* imageRes);
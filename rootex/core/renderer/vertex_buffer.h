@@ -15,6 +15,8 @@ class VertexBuffer
 
 public:
 	VertexBuffer(const Vector<VertexData>& buffer);
+	/// Vertices are read straight from the pointer, so it can point into a mapped file.
+	VertexBuffer(const VertexData* vertices, unsigned int count);
 	VertexBuffer(const Vector<UIVertexData>& buffer);
 	VertexBuffer(const Vector<float>& buffer);
 	~VertexBuffer() = default;
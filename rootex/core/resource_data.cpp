@@ -14,12 +14,50 @@ FilePath ResourceData::getPath()
 
 FileBuffer* ResourceData::getRawData()
 {
+	if (m_Mapping)
+	{
+		ERR("Mapped data needs to be made writable before it is written to: " + m_Path.generic_string());
+	}
 	return &m_FileBuffer;
 }
 
+void ResourceData::makeWritable()
+{
+	if (m_Mapping)
+	{
+		m_FileBuffer.assign(m_MappedData, m_MappedData + m_MappedSize);
+		m_Mapping.reset();
+	}
+}
+
+const char* ResourceData::getReadOnlyData() const
+{
+	return m_Mapping ? m_MappedData : m_FileBuffer.data();
+}
+
 unsigned int ResourceData::getRawDataByteSize()
 {
-	return m_FileBuffer.size();
+	return m_Mapping ? m_MappedSize : m_FileBuffer.size();
+}
+
+void ResourceData::setBuffer(FileBuffer buffer)
+{
+	m_FileBuffer = std::move(buffer);
+	m_Mapping.reset();
+}
+
+void ResourceData::setMapping(const Ref<FileMapping>& mapping)
+{
+	setMapping(mapping, mapping->getData(), mapping->getSize());
+}
+
+void ResourceData::setMapping(const Ref<FileMapping>& mapping, const char* data, size_t size)
+{
+	m_FileBuffer.clear();
+	m_FileBuffer.shrink_to_fit();
+	m_Mapping = mapping;
+	m_MappedData = data;
+	m_MappedSize = size;
 }
 
 void ResourceData::setPath(String path)
@@ -45,8 +83,8 @@ ResourceData::operator bool() const
 
 void ResourceData::startStream()
 {
-	m_StreamStart = &m_FileBuffer.front();
-	m_StreamEnd = &m_FileBuffer.back();
+	m_StreamStart = getReadOnlyData();
+	m_StreamEnd = getReadOnlyData() + getRawDataByteSize() - 1;
 }
 
 bool ResourceData::isEndOfFile()
@@ -56,12 +94,29 @@ bool ResourceData::isEndOfFile()
 
 void ResourceData::resetStream()
 {
-	m_StreamStart = &m_FileBuffer.front();
+	m_StreamStart = getReadOnlyData();
+}
+
+ResourceData::ResourceData(FilePath path, FileBuffer data)
+    : m_ID(s_Count)
+    , m_FileBuffer(std::move(data))
+    , m_MappedData(nullptr)
+    , m_MappedSize(0)
+    , m_Path(path.generic_string())
+{
+	s_Count++;
+}
+
+ResourceData::ResourceData(FilePath path, const Ref<FileMapping>& mapping)
+    : ResourceData(path, mapping, mapping->getData(), mapping->getSize())
+{
 }
 
-ResourceData::ResourceData(FilePath path, FileBuffer& data)
+ResourceData::ResourceData(FilePath path, const Ref<FileMapping>& mapping, const char* data, size_t size)
     : m_ID(s_Count)
-    , m_FileBuffer(data)
+    , m_Mapping(mapping)
+    , m_MappedData(data)
+    , m_MappedSize(size)
     , m_Path(path.generic_string())
 {
 	s_Count++;
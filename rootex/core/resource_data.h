@@ -16,7 +16,11 @@
 /// Convert megabytes to gigabytes
 #define MB_TO_GB (1.0f / GB_TO_MB)
 
+/// Files at least this large are mapped into memory instead of being read.
+#define MAPPED_FILE_MIN_SIZE (64 * 1024)
+
 /// Representation of a ResourceFile data buffer. Contains a faceless collection of bytes loaded from disk.
+/// The bytes either live in a buffer or, for large files, in a read only mapping of the file that is kept till the data is replaced.
 class ResourceData
 {
 	static unsigned int s_Count;
@@ -24,21 +28,43 @@ class ResourceData
 protected:
 	unsigned int m_ID;
 	FileBuffer m_FileBuffer;
+	/// Set if the data is read straight from a mapped file. m_FileBuffer is empty then.
+	Ref<FileMapping> m_Mapping;
+	/// Part of the mapped file holding the data. Files packed in archives take up only a part of the mapping.
+	const char* m_MappedData;
+	size_t m_MappedSize;
 	FilePath m_Path;
 
-	char* m_StreamStart;
+	const char* m_StreamStart;
 	const char* m_StreamEnd;
 
 public:
-	ResourceData(FilePath path, FileBuffer& data);
+	ResourceData(FilePath path, FileBuffer data);
+	ResourceData(FilePath path, const Ref<FileMapping>& mapping);
+	/// Data is size bytes starting at data, inside the mapping.
+	ResourceData(FilePath path, const Ref<FileMapping>& mapping, const char* data, size_t size);
 	~ResourceData() = default;
 
 	unsigned int getID();
 	FilePath getPath();
-	/// Get the collection of bytes in a file
+	/// Get the buffer holding the bytes in a file, to write to it. Use getReadOnlyData() for reading.
+	/// Mapped data has to be copied into the buffer with makeWritable() first. Returns an empty buffer and logs an error otherwise.
 	FileBuffer* getRawData();
+	/// Get the bytes in a file without copying them. Stays valid till the data is replaced or made writable.
+	const char* getReadOnlyData() const;
+	/// Copy mapped data into a buffer and drop the mapping, so that it can be written through getRawData().
+	/// Pointers returned by getReadOnlyData() before are left dangling. Does nothing if the data isn't mapped.
+	void makeWritable();
 	/// Get the number of bytes in a file
 	unsigned int getRawDataByteSize();
+	bool isMapped() const { return m_Mapping != nullptr; }
+
+	/// Replace the data with a buffer, dropping any mapping.
+	void setBuffer(FileBuffer buffer);
+	/// Replace the data with a mapped file.
+	void setMapping(const Ref<FileMapping>& mapping);
+	/// Replace the data with size bytes starting at data, inside the mapping.
+	void setMapping(const Ref<FileMapping>& mapping, const char* data, size_t size);
 
 	/// Set the path of file loaded. Potentially dangerous to use if you don't know what gets effected.
 	void setPath(String path);
@@ -14,7 +14,7 @@ ResourceFile::ResourceFile(const Type& type, ResourceData* resData)
 {
 	PANIC(resData == nullptr, "Null resource found. Resource of this type has not been loaded correctly: " + std::to_string((int)type));
 	m_LastReadTime = OS::s_FileSystemClock.now();
-	m_LastChangedTime = OS::GetFileLastChangedTime(getPath().string());
+	m_LastChangedTime = getLastChangedTime();
 }
 
 void ResourceFile::RegisterAPI(sol::table& rootex)
@@ -58,7 +58,8 @@ ResourceData* ResourceFile::getData()
 
 const FileTimePoint& ResourceFile::getLastChangedTime()
 {
-	m_LastChangedTime = OS::GetFileLastChangedTime(getPath().string());
+	// Archived files have no loose file to check and never change
+	m_LastChangedTime = ResourceLoader::IsArchived(getPath().generic_string()) ? m_LastReadTime : OS::GetFileLastChangedTime(getPath().string());
 	return m_LastChangedTime;
 }
 
@@ -114,24 +115,26 @@ void TextResourceFile::RegisterAPI(sol::table& rootex)
 
 void TextResourceFile::putString(const String& newData)
 {
-	*m_ResourceData->getRawData() = FileBuffer(newData.begin(), newData.end());
+	m_ResourceData->setBuffer(FileBuffer(newData.begin(), newData.end()));
 }
 
 void TextResourceFile::popBack()
 {
+	m_ResourceData->makeWritable();
 	m_ResourceData->getRawData()->pop_back();
 }
 
 void TextResourceFile::append(const String& add)
 {
+	m_ResourceData->makeWritable();
 	m_ResourceData->getRawData()->insert(m_ResourceData->getRawData()->end(), add.begin(), add.end());
 }
 
 String TextResourceFile::getString() const
 {
 	return String(
-	    m_ResourceData->getRawData()->begin(),
-	    m_ResourceData->getRawData()->end());
+	    m_ResourceData->getReadOnlyData(),
+	    m_ResourceData->getRawDataByteSize());
 }
 
 LuaTextResourceFile::LuaTextResourceFile(ResourceData* resData)
@@ -194,7 +197,7 @@ FontResourceFile::~FontResourceFile()
 
 void FontResourceFile::regenerateFont()
 {
-	m_Font = RenderingDevice::GetSingleton()->createFont(m_ResourceData->getRawData());
+	m_Font = RenderingDevice::GetSingleton()->createFont(m_ResourceData->getReadOnlyData(), m_ResourceData->getRawDataByteSize());
 	m_Font->SetDefaultCharacter('X');
 }
 
@@ -17,8 +17,39 @@
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/MemoryIOWrapper.h>
 
-HashMap<Ptr<ResourceData>, Ptr<ResourceFile>> ResourceLoader::s_ResourcesDataFiles;
+/// Lets Assimp read models, and the files that models refer to, out of the mounted archives.
+class ArchiveIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+	bool Exists(const char* file) const override
+	{
+		const AssetArchive::Entry* entry = nullptr;
+		return ResourceLoader::FindArchive(ResourceLoader::NormalizePath(file), entry) || DefaultIOSystem::Exists(file);
+	}
+
+	Assimp::IOStream* Open(const char* file, const char* mode) override
+	{
+		const AssetArchive::Entry* entry = nullptr;
+		if (AssetArchive* archive = ResourceLoader::FindArchive(ResourceLoader::NormalizePath(file), entry))
+		{
+			return new Assimp::MemoryIOStream((const uint8_t*)archive->getData(entry), entry->m_Size);
+		}
+		return DefaultIOSystem::Open(file, mode);
+	}
+};
+
+Vector<Ptr<AssetArchive>> ResourceLoader::s_Archives;
+HashMap<ResourceFile::Type, HashMap<String, Ref<ResourceLoader::CachedResource>>> ResourceLoader::s_Cache;
+std::mutex ResourceLoader::s_CacheMutex;
+std::condition_variable ResourceLoader::s_LoadedVariable;
+std::priority_queue<Ref<AsyncResourceLoad>, Vector<Ref<AsyncResourceLoad>>, ResourceLoader::AsyncLoadOrder> ResourceLoader::s_PendingLoads;
+std::mutex ResourceLoader::s_PendingLoadsMutex;
+unsigned int ResourceLoader::s_LoadSequence = 0;
+TaskCounter ResourceLoader::s_AsyncLoads;
+ConcurrentQueue<Ref<AsyncResourceLoad>> ResourceLoader::s_DoneLoads;
 
 bool IsFileSupported(const String& extension, ResourceFile::Type supportedFileType)
 {
@@ -31,225 +62,262 @@ bool IsFileSupported(const String& extension, ResourceFile::Type supportedFileTy
 	return false;
 }
 
-void ResourceLoader::LoadAssimp(ModelResourceFile* file)
+const aiScene* ResourceLoader::ImportAssimp(const String& path, Assimp::Importer& importer)
 {
-	Assimp::Importer modelLoader;
-	const aiScene* scene = modelLoader.ReadFile(
-	    file->getPath().generic_string(),
+	if (!s_Archives.empty())
+	{
+		importer.SetIOHandler(new ArchiveIOSystem());
+	}
+	const aiScene* scene = importer.ReadFile(
+	    path,
 	    aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeMeshes | aiProcess_CalcTangentSpace);
 
 	if (!scene)
 	{
-		ERR("Model could not be loaded: " + OS::GetAbsolutePath(file->m_ResourceData->getPath().string()).generic_string());
-		ERR("Assimp: " + modelLoader.GetErrorString());
-		return;
+		ERR("Model could not be loaded: " + OS::GetAbsolutePath(path).generic_string());
+		ERR("Assimp: " + importer.GetErrorString());
 	}
+	return scene;
+}
 
-	Vector<Ref<Texture>> textures;
-	textures.resize(scene->mNumTextures, nullptr);
-	file->m_Meshes.clear();
-	for (int i = 0; i < scene->mNumMeshes; i++)
-	{
-		const aiMesh* mesh = scene->mMeshes[i];
+void ResourceLoader::ExtractAssimpMesh(const aiMesh* mesh, CookedModel::MeshData& data)
+{
+	data.m_Vertices.clear();
+	data.m_Vertices.reserve(mesh->mNumVertices);
 
-		Vector<VertexData> vertices;
-		vertices.reserve(mesh->mNumVertices);
+	VertexData vertex;
+	ZeroMemory(&vertex, sizeof(VertexData));
+	for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+	{
+		vertex.m_Position.x = mesh->mVertices[v].x;
+		vertex.m_Position.y = mesh->mVertices[v].y;
+		vertex.m_Position.z = mesh->mVertices[v].z;
 
-		VertexData vertex;
-		ZeroMemory(&vertex, sizeof(VertexData));
-		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+		if (mesh->mNormals)
 		{
-			vertex.m_Position.x = mesh->mVertices[v].x;
-			vertex.m_Position.y = mesh->mVertices[v].y;
-			vertex.m_Position.z = mesh->mVertices[v].z;
+			vertex.m_Normal.x = mesh->mNormals[v].x;
+			vertex.m_Normal.y = mesh->mNormals[v].y;
+			vertex.m_Normal.z = mesh->mNormals[v].z;
+		}
 
-			if (mesh->mNormals)
+		if (mesh->mTextureCoords)
+		{
+			if (mesh->mTextureCoords[0])
 			{
-				vertex.m_Normal.x = mesh->mNormals[v].x;
-				vertex.m_Normal.y = mesh->mNormals[v].y;
-				vertex.m_Normal.z = mesh->mNormals[v].z;
+				// Assuming the model has texture coordinates and taking only the first texture coordinate in case of multiple texture coordinates
+				vertex.m_TextureCoord.x = mesh->mTextureCoords[0][v].x;
+				vertex.m_TextureCoord.y = mesh->mTextureCoords[0][v].y;
 			}
+		}
 
-			if (mesh->mTextureCoords)
-			{
-				if (mesh->mTextureCoords[0])
-				{
-					// Assuming the model has texture coordinates and taking only the first texture coordinate in case of multiple texture coordinates
-					vertex.m_TextureCoord.x = mesh->mTextureCoords[0][v].x;
-					vertex.m_TextureCoord.y = mesh->mTextureCoords[0][v].y;
-				}
-			}
+		if (mesh->mTangents)
+		{
+			vertex.m_Tangent.x = mesh->mTangents[v].x;
+			vertex.m_Tangent.y = mesh->mTangents[v].y;
+			vertex.m_Tangent.z = mesh->mTangents[v].z;
+		}
 
-			if (mesh->mTangents)
-			{
-				vertex.m_Tangent.x = mesh->mTangents[v].x;
-				vertex.m_Tangent.y = mesh->mTangents[v].y;
-				vertex.m_Tangent.z = mesh->mTangents[v].z;
-			}
+		data.m_Vertices.push_back(vertex);
+	}
 
-			vertices.push_back(vertex);
-		}
+	data.m_Indices.clear();
+	data.m_Indices.reserve(mesh->mNumFaces * 3);
 
-		std::vector<unsigned short> indices;
+	aiFace* face = nullptr;
+	for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+	{
+		face = &mesh->mFaces[f];
+		//Model already triangulated by aiProcess_Triangulate so no need to check
+		data.m_Indices.push_back(face->mIndices[0]);
+		data.m_Indices.push_back(face->mIndices[1]);
+		data.m_Indices.push_back(face->mIndices[2]);
+	}
+}
 
-		aiFace* face = nullptr;
-		for (unsigned int f = 0; f < mesh->mNumFaces; f++)
-		{
-			face = &mesh->mFaces[f];
-			//Model already triangulated by aiProcess_Triangulate so no need to check
-			indices.push_back(face->mIndices[0]);
-			indices.push_back(face->mIndices[1]);
-			indices.push_back(face->mIndices[2]);
-		}
+Ref<BasicMaterial> ResourceLoader::LoadAssimpMaterial(const FilePath& modelPath, const aiScene* scene, aiMaterial* material, Vector<Ref<Texture>>& textures, String& materialPath)
+{
+	aiColor3D color(0.0f, 0.0f, 0.0f);
+	float alpha = 1.0f;
+	if (AI_SUCCESS != material->Get(AI_MATKEY_COLOR_DIFFUSE, color))
+	{
+		WARN("Material does not have color: " + String(material->GetName().C_Str()));
+	}
+	if (AI_SUCCESS != material->Get(AI_MATKEY_OPACITY, alpha))
+	{
+		WARN("Material does not have alpha: " + String(material->GetName().C_Str()));
+	}
 
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+	Ref<BasicMaterial> extractedMaterial;
+	
+	if (String(material->GetName().C_Str()) == "DefaultMaterial")
+	{
+		materialPath = "rootex/assets/materials/default.rmat";
+	}
+	else
+	{
+		materialPath = "game/assets/materials/" + String(material->GetName().C_Str()) + ".rmat";
+	}
 
-		aiColor3D color(0.0f, 0.0f, 0.0f);
-		float alpha = 1.0f;
-		if (AI_SUCCESS != material->Get(AI_MATKEY_COLOR_DIFFUSE, color))
-		{
-			WARN("Material does not have color: " + String(material->GetName().C_Str()));
-		}
-		if (AI_SUCCESS != material->Get(AI_MATKEY_OPACITY, alpha))
-		{
-			WARN("Material does not have alpha: " + String(material->GetName().C_Str()));
-		}
+	if (MaterialLibrary::IsExists(materialPath))
+	{
+		extractedMaterial = std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial(materialPath));
+	}
+	else
+	{
+		MaterialLibrary::CreateNewMaterialFile(materialPath, "BasicMaterial");
+		extractedMaterial = std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial(materialPath));
+		extractedMaterial->setColor({ color.r, color.g, color.b, alpha });
 
-		Ref<BasicMaterial> extractedMaterial;
-		
-		String materialPath;
-		if (String(material->GetName().C_Str()) == "DefaultMaterial")
+		for (int i = 0; i < material->GetTextureCount(aiTextureType_DIFFUSE); i++)
 		{
-			materialPath = "rootex/assets/materials/default.rmat";
-		}
-		else
-		{
-			materialPath = "game/assets/materials/" + String(material->GetName().C_Str()) + ".rmat";
-		}
+			aiString str;
+			material->GetTexture(aiTextureType_DIFFUSE, i, &str);
+				
+			char embeddedAsterisk = *str.C_Str();
 
-		if (MaterialLibrary::IsExists(materialPath))
-		{
-			extractedMaterial = std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial(materialPath));
-		}
-		else
-		{
-			MaterialLibrary::CreateNewMaterialFile(materialPath, "BasicMaterial");
-			extractedMaterial = std::dynamic_pointer_cast<BasicMaterial>(MaterialLibrary::GetMaterial(materialPath));
-			extractedMaterial->setColor({ color.r, color.g, color.b, alpha });
+			if (embeddedAsterisk == '*')
+			{
+				// Texture is embedded
+				int textureID = atoi(str.C_Str() + 1);
+
+				if (!textures[textureID])
+				{
+					aiTexture* texture = scene->mTextures[textureID];
+					size_t size = scene->mTextures[textureID]->mWidth;
+					PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
+					textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
+				}
 
-			for (int i = 0; i < material->GetTextureCount(aiTextureType_DIFFUSE); i++)
+				extractedMaterial->setTextureInternal(textures[textureID]);
+			}
+			else
 			{
-				aiString str;
-				material->GetTexture(aiTextureType_DIFFUSE, i, &str);
-					
-				char embeddedAsterisk = *str.C_Str();
+				// Texture is given as a path
+				String texturePath = str.C_Str();
+				ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(modelPath.parent_path().generic_string() + "/" + texturePath);
 
-				if (embeddedAsterisk == '*')
+				if (image)
 				{
-					// Texture is embedded
-					int textureID = atoi(str.C_Str() + 1);
-
-					if (!textures[textureID])
-					{
-						aiTexture* texture = scene->mTextures[textureID];
-						size_t size = scene->mTextures[textureID]->mWidth;
-						PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
-						textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
-					}
-
-					extractedMaterial->setTextureInternal(textures[textureID]);
+					extractedMaterial->setTexture(image);
 				}
 				else
 				{
-					// Texture is given as a path
-					String texturePath = str.C_Str();
-					ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(file->getPath().parent_path().generic_string() + "/" + texturePath);
-
-					if (image)
-					{
-						extractedMaterial->setTexture(image);
-					}
-					else
-					{
-						WARN("Could not set material diffuse texture: " + texturePath);
-					}
+					WARN("Could not set material diffuse texture: " + texturePath);
 				}
 			}
+		}
 
-			for (int i = 0; i < material->GetTextureCount(aiTextureType_NORMALS); i++)
+		for (int i = 0; i < material->GetTextureCount(aiTextureType_NORMALS); i++)
+		{
+			aiString normalStr;
+			material->GetTexture(aiTextureType_NORMALS, i, &normalStr);
+			char embeddedAsterisk = *normalStr.C_Str();
+			if (embeddedAsterisk == '*')
 			{
-				aiString normalStr;
-				material->GetTexture(aiTextureType_NORMALS, i, &normalStr);
-				char embeddedAsterisk = *normalStr.C_Str();
-				if (embeddedAsterisk == '*')
+				int textureID = atoi(normalStr.C_Str() + 1);
+
+				if (!textures[textureID])
 				{
-					int textureID = atoi(normalStr.C_Str() + 1);
+					aiTexture* texture = scene->mTextures[textureID];
+					size_t size = scene->mTextures[textureID]->mWidth;
+					PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
+					textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
+				}
 
-					if (!textures[textureID])
-					{
-						aiTexture* texture = scene->mTextures[textureID];
-						size_t size = scene->mTextures[textureID]->mWidth;
-						PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
-						textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
-					}
+				extractedMaterial->setNormalInternal(textures[textureID]);
+			}
+			else
+			{
+				String texturePath = normalStr.C_Str();
+				ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(modelPath.parent_path().generic_string() + "/" + texturePath);
 
-					extractedMaterial->setNormalInternal(textures[textureID]);
+				if (image)
+				{
+					extractedMaterial->setNormal(image);
 				}
 				else
 				{
-					String texturePath = normalStr.C_Str();
-					ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(file->getPath().parent_path().generic_string() + "/" + texturePath);
-
-					if (image)
-					{
-						extractedMaterial->setNormal(image);
-					}
-					else
-					{
-						WARN("Could not set material normal map texture: " + texturePath);
-					}
+					WARN("Could not set material normal map texture: " + texturePath);
 				}
 			}
+		}
 
-			for (int i = 0; i < material->GetTextureCount(aiTextureType_SPECULAR); i++)
+		for (int i = 0; i < material->GetTextureCount(aiTextureType_SPECULAR); i++)
+		{
+			aiString specularStr;
+			material->GetTexture(aiTextureType_SPECULAR, i, &specularStr);
+			char embeddedAsterisk = *specularStr.C_Str();
+			if (embeddedAsterisk == '*')
 			{
-				aiString specularStr;
-				material->GetTexture(aiTextureType_SPECULAR, i, &specularStr);
-				char embeddedAsterisk = *specularStr.C_Str();
-				if (embeddedAsterisk == '*')
+				int textureID = atoi(specularStr.C_Str() + 1);
+
+				if (!textures[textureID])
 				{
-					int textureID = atoi(specularStr.C_Str() + 1);
+					aiTexture* texture = scene->mTextures[textureID];
+					size_t size = scene->mTextures[textureID]->mWidth;
+					PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
+					textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
+				}
 
-					if (!textures[textureID])
-					{
-						aiTexture* texture = scene->mTextures[textureID];
-						size_t size = scene->mTextures[textureID]->mWidth;
-						PANIC(texture->mHeight == 0, "Compressed texture found but expected embedded texture");
-						textures[textureID].reset(new Texture(reinterpret_cast<const char*>(texture->pcData), size));
-					}
+				extractedMaterial->setSpecularInternal(textures[textureID]);
+			}
+			else
+			{
+				String texturePath = specularStr.C_Str();
+				ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(modelPath.parent_path().generic_string() + "/" + texturePath);
 
-					extractedMaterial->setSpecularInternal(textures[textureID]);
+				if (image)
+				{
+					extractedMaterial->setSpecularTexture(image);
 				}
 				else
 				{
-					String texturePath = specularStr.C_Str();
-					ImageResourceFile* image = ResourceLoader::CreateImageResourceFile(file->getPath().parent_path().generic_string() + "/" + texturePath);
-
-					if (image)
-					{
-						extractedMaterial->setSpecularTexture(image);
-					}
-					else
-					{
-						WARN("Could not set material specular map texture: " + texturePath);
-					}
+					WARN("Could not set material specular map texture: " + texturePath);
 				}
 			}
 		}
+	}
+
+	return extractedMaterial;
+}
+
+void ResourceLoader::LoadAssimp(ModelResourceFile* file)
+{
+	Assimp::Importer modelLoader;
+	const aiScene* scene = ImportAssimp(file->getPath().generic_string(), modelLoader);
+	if (!scene)
+	{
+		return;
+	}
+
+	Vector<Ref<Texture>> textures;
+	textures.resize(scene->mNumTextures, nullptr);
+	file->m_Meshes.clear();
+	CookedModel::MeshData data;
+	for (int i = 0; i < scene->mNumMeshes; i++)
+	{
+		const aiMesh* mesh = scene->mMeshes[i];
+		if (mesh->mNumVertices == 0 || mesh->mNumFaces == 0)
+		{
+			WARN("Skipped empty mesh: " + String(mesh->mName.C_Str()) + " in " + file->getPath().generic_string());
+			continue;
+		}
+		ExtractAssimpMesh(mesh, data);
+
+		String materialPath;
+		Ref<BasicMaterial> extractedMaterial = LoadAssimpMaterial(file->getPath(), scene, scene->mMaterials[mesh->mMaterialIndex], textures, materialPath);
 
 		Mesh extractedMesh;
-		extractedMesh.m_VertexBuffer.reset(new VertexBuffer(vertices));
-		extractedMesh.m_IndexBuffer.reset(new IndexBuffer(indices));
+		extractedMesh.m_VertexBuffer.reset(new VertexBuffer(data.m_Vertices));
+		if (data.m_Vertices.size() <= USHRT_MAX)
+		{
+			extractedMesh.m_IndexBuffer.reset(new IndexBuffer(Vector<unsigned short>(data.m_Indices.begin(), data.m_Indices.end())));
+		}
+		else
+		{
+			extractedMesh.m_IndexBuffer.reset(new IndexBuffer((const unsigned int*)data.m_Indices.data(), data.m_Indices.size()));
+		}
+		BoundingBox::CreateFromPoints(extractedMesh.m_BoundingBox, data.m_Vertices.size(), &data.m_Vertices.front().m_Position, sizeof(VertexData));
 		
 		bool found = false;
 		for (auto& materialModels : file->getMeshes())
@@ -269,6 +337,133 @@ void ResourceLoader::LoadAssimp(ModelResourceFile* file)
 	}
 }
 
+bool ResourceLoader::LoadCookedModel(ModelResourceFile* file)
+{
+	String modelPath = NormalizePath(file->getPath().generic_string());
+	String cookedPath = CookedModel::GetCookedPath(modelPath);
+	if (!IsArchived(cookedPath))
+	{
+		if (!OS::IsExists(cookedPath))
+		{
+			return false;
+		}
+		// Models edited since they were cooked are imported again until they are cooked again
+		if (!IsArchived(modelPath) && OS::GetFileLastChangedTime(cookedPath) < OS::GetFileLastChangedTime(modelPath))
+		{
+			WARN("Cooked model is out of date, importing the model instead: " + modelPath);
+			return false;
+		}
+	}
+
+	Ptr<ResourceData> cookedData(LoadResourceData(cookedPath));
+	Ptr<CookedModel> cooked = CookedModel::Open(cookedData->getReadOnlyData(), cookedData->getRawDataByteSize());
+	if (!cooked)
+	{
+		WARN("Cooked model is invalid or was cooked by an older version, importing the model instead: " + cookedPath);
+		return false;
+	}
+
+	file->m_Meshes.clear();
+	unsigned int meshIndex = 0;
+	for (unsigned int i = 0; i < cooked->getMaterialCount(); i++)
+	{
+		const CookedModel::MaterialEntry& material = cooked->getMaterial(i);
+
+		Vector<Mesh> meshes;
+		meshes.reserve(material.m_MeshCount);
+		for (unsigned int m = 0; m < material.m_MeshCount; m++)
+		{
+			const CookedModel::MeshEntry& meshEntry = cooked->getMesh(meshIndex++);
+
+			// The GPU buffers are filled straight from the cooked file
+			Mesh mesh;
+			mesh.m_VertexBuffer.reset(new VertexBuffer(cooked->getVertices(meshEntry), meshEntry.m_VertexCount));
+			if (meshEntry.m_IndexSize == sizeof(uint16_t))
+			{
+				mesh.m_IndexBuffer.reset(new IndexBuffer((const unsigned short*)cooked->getIndices(meshEntry), meshEntry.m_IndexCount));
+			}
+			else
+			{
+				mesh.m_IndexBuffer.reset(new IndexBuffer((const unsigned int*)cooked->getIndices(meshEntry), meshEntry.m_IndexCount));
+			}
+			mesh.m_BoundingBox = CookedModel::GetBounds(meshEntry);
+			meshes.push_back(mesh);
+		}
+
+		file->m_Meshes.push_back(Pair<Ref<Material>, Vector<Mesh>>(MaterialLibrary::GetMaterial(cooked->getMaterialPath(material)), meshes));
+	}
+	return true;
+}
+
+void ResourceLoader::LoadModel(ModelResourceFile* file)
+{
+	if (!LoadCookedModel(file))
+	{
+		LoadAssimp(file);
+	}
+}
+
+bool ResourceLoader::CookModel(const String& path)
+{
+	Assimp::Importer modelLoader;
+	const aiScene* scene = ImportAssimp(path, modelLoader);
+	if (!scene)
+	{
+		return false;
+	}
+	if (scene->mNumTextures > 0)
+	{
+		// Embedded textures are not saved to the material files, so the model needs to be imported every time
+		WARN("Models with embedded textures are not cooked: " + path);
+		return false;
+	}
+
+	Vector<Ref<Texture>> textures;
+	Vector<Pair<String, Vector<CookedModel::MeshData>>> materialMeshes;
+	for (int i = 0; i < scene->mNumMeshes; i++)
+	{
+		const aiMesh* mesh = scene->mMeshes[i];
+		if (mesh->mNumVertices == 0 || mesh->mNumFaces == 0)
+		{
+			WARN("Skipped empty mesh: " + String(mesh->mName.C_Str()) + " in " + path);
+			continue;
+		}
+
+		String materialPath;
+		if (!LoadAssimpMaterial(path, scene, scene->mMaterials[mesh->mMaterialIndex], textures, materialPath))
+		{
+			continue;
+		}
+
+		auto findIt = std::find_if(materialMeshes.begin(), materialMeshes.end(), [&materialPath](const Pair<String, Vector<CookedModel::MeshData>>& materialMesh) {
+			return materialMesh.first == materialPath;
+		});
+		if (findIt == materialMeshes.end())
+		{
+			materialMeshes.push_back({ materialPath, {} });
+			findIt = materialMeshes.end() - 1;
+		}
+
+		findIt->second.emplace_back();
+		ExtractAssimpMesh(mesh, findIt->second.back());
+	}
+
+	return CookedModel::Write(CookedModel::GetCookedPath(NormalizePath(path)), materialMeshes);
+}
+
+void ResourceLoader::CookModels(const String& directory)
+{
+	int cookedCount = 0;
+	for (auto& file : OS::GetAllFilesInDirectory(directory))
+	{
+		if (IsFileSupported(file.extension().generic_string(), ResourceFile::Type::Model) && CookModel(file.generic_string()))
+		{
+			cookedCount++;
+		}
+	}
+	PRINT("Cooked " + std::to_string(cookedCount) + " models in " + directory);
+}
+
 void ResourceLoader::LoadALUT(AudioResourceFile* audioRes, const char* audioBuffer, int format, int size, float frequency)
 {
 	audioRes->m_DecompressedAudioBuffer = audioBuffer;
@@ -306,232 +501,376 @@ void ResourceLoader::LoadALUT(AudioResourceFile* audioRes, const char* audioBuff
 	audioRes->m_Duration /= frequency;
 }
 
-ResourceFile* ResourceLoader::CreateSomeResourceFile(const String& path)
+ResourceFile::Type ResourceLoader::GetResourceType(const String& path)
 {
-	ResourceFile* result = nullptr;
+	String extension = FilePath(path).extension().generic_string();
 	for (auto& [resourceType, extensions] : SupportedFiles)
 	{
-		if (std::find(extensions.begin(), extensions.end(), FilePath(path).extension().generic_string()) != extensions.end())
+		if (std::find(extensions.begin(), extensions.end(), extension) != extensions.end())
 		{
-			switch (resourceType)
-			{
-			case ResourceFile::Type::Text:
-				result = CreateTextResourceFile(path);
-				break;
-			case ResourceFile::Type::Audio:
-				result = CreateAudioResourceFile(path);
-				break;
-			case ResourceFile::Type::Font:
-				result = CreateFontResourceFile(path);
-				break;
-			case ResourceFile::Type::Image:
-				result = CreateImageResourceFile(path);
-				break;
-			case ResourceFile::Type::Lua:
-				result = CreateLuaTextResourceFile(path);
-				break;
-			case ResourceFile::Type::Model:
-				result = CreateModelResourceFile(path);
-				break;
-			default:
-				break;
-			}
+			return resourceType;
 		}
 	}
-	return result;
+	return ResourceFile::Type::None;
 }
 
-void ResourceLoader::RegisterAPI(sol::table& rootex)
+ResourceFile* ResourceLoader::CreateResourceFile(ResourceFile::Type type, const String& path)
 {
-	sol::usertype<ResourceLoader> resourceLoader = rootex.new_usertype<ResourceLoader>("ResourceLoader");
-	resourceLoader["CreateAudio"] = &ResourceLoader::CreateAudioResourceFile;
-	resourceLoader["CreateFont"] = &ResourceLoader::CreateFontResourceFile;
-	resourceLoader["CreateImage"] = &ResourceLoader::CreateImageResourceFile;
-	resourceLoader["CreateLua"] = &ResourceLoader::CreateLuaTextResourceFile;
-	resourceLoader["CreateText"] = &ResourceLoader::CreateTextResourceFile;
-	resourceLoader["CreateNewText"] = &ResourceLoader::CreateNewTextResourceFile;
-	resourceLoader["CreateVisualModel"] = &ResourceLoader::CreateModelResourceFile;
+	switch (type)
+	{
+	case ResourceFile::Type::Text:
+		return CreateTextResourceFile(path);
+	case ResourceFile::Type::Audio:
+		return CreateAudioResourceFile(path);
+	case ResourceFile::Type::Font:
+		return CreateFontResourceFile(path);
+	case ResourceFile::Type::Image:
+		return CreateImageResourceFile(path);
+	case ResourceFile::Type::Lua:
+		return CreateLuaTextResourceFile(path);
+	case ResourceFile::Type::Model:
+		return CreateModelResourceFile(path);
+	default:
+		return nullptr;
+	}
 }
 
-TextResourceFile* ResourceLoader::CreateTextResourceFile(const String& path)
+ResourceFile* ResourceLoader::CreateSomeResourceFile(const String& path)
+{
+	return CreateResourceFile(GetResourceType(path), path);
+}
+
+Ref<AsyncResourceLoad> ResourceLoader::StartLoad(const String& path, ResourceFile::Type type, LoadPriority priority, Atomic<int>* progress)
 {
-	for (auto& item : s_ResourcesDataFiles)
+	Ref<AsyncResourceLoad> load(new AsyncResourceLoad(NormalizePath(path), type, priority));
+	load->m_Progress = progress;
+
 	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Text)
+		std::lock_guard<std::mutex> lock(s_CacheMutex);
+		auto& files = s_Cache[type];
+		auto findIt = files.find(load->m_Path);
+		if (findIt != files.end() && findIt->second->m_IsLoaded)
 		{
-			return reinterpret_cast<TextResourceFile*>(item.second.get());
+			// Already loaded, no need to bother the worker threads
+			load->m_File = findIt->second->m_File.get();
+			if (progress)
+			{
+				(*progress)++;
+			}
+			load->m_Counter.decrement();
+			return load;
 		}
 	}
 
-	if (OS::IsExists(path) == false)
 	{
-		ERR("File not found: " + path);
-		return nullptr;
+		std::lock_guard<std::mutex> lock(s_PendingLoadsMutex);
+		load->m_Sequence = s_LoadSequence++;
+		s_PendingLoads.push(load);
 	}
+	s_AsyncLoads.increment();
+	// Every task runs whichever load is the most urgent at the time, not necessarily this one
+	Application::GetSingleton()->getThreadPool().submit(RunPendingLoad);
 
-	// File not found in cache, load it only once
-	FileBuffer& buffer = OS::LoadFileContents(path);
-	ResourceData* resData = new ResourceData(path, buffer);
-	TextResourceFile* textRes = new TextResourceFile(ResourceFile::Type::Text, resData);
-
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(textRes);
-	return textRes;
+	return load;
 }
 
-TextResourceFile* ResourceLoader::CreateNewTextResourceFile(const String& path)
+void ResourceLoader::RunPendingLoad()
 {
-	if (!OS::IsExists(path))
+	Ref<AsyncResourceLoad> load;
 	{
-		OS::CreateFileName(path);
+		std::lock_guard<std::mutex> lock(s_PendingLoadsMutex);
+		if (s_PendingLoads.empty())
+		{
+			return;
+		}
+		load = s_PendingLoads.top();
+		s_PendingLoads.pop();
 	}
-	return CreateTextResourceFile(path);
+
+	load->m_File = CreateResourceFile(load->m_Type, load->m_Path);
+	if (load->m_Progress)
+	{
+		(*load->m_Progress)++;
+	}
+	load->m_Counter.decrement();
+	s_DoneLoads.push(load);
+	s_AsyncLoads.decrement();
 }
 
-LuaTextResourceFile* ResourceLoader::CreateLuaTextResourceFile(const String& path)
+void ResourceLoader::WaitForLoad(AsyncResourceLoad& load)
+{
+	Application::GetSingleton()->getThreadPool().wait(load.m_Counter);
+}
+
+void ResourceLoader::AddCallback(const Ref<AsyncResourceLoad>& load, const Function<void(ResourceFile*)>& callback)
 {
-	for (auto& item : s_ResourcesDataFiles)
 	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Lua)
-		{
-			return reinterpret_cast<LuaTextResourceFile*>(item.second.get());
-		}
+		std::lock_guard<std::mutex> lock(load->m_CallbacksMutex);
+		load->m_Callbacks.push_back(callback);
+	}
+	// Loads done before this callback was added have already been through the done queue
+	if (load->m_Counter.isDone())
+	{
+		s_DoneLoads.push(load);
 	}
+}
+
+void ResourceLoader::DispatchCallbacks()
+{
+	Vector<Ref<AsyncResourceLoad>> doneLoads;
+	s_DoneLoads.popAll(doneLoads);
 
-	if (OS::IsExists(path) == false)
+	for (auto& load : doneLoads)
 	{
-		ERR("File not found: " + path);
-		return nullptr;
+		Vector<Function<void(ResourceFile*)>> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(load->m_CallbacksMutex);
+			callbacks.swap(load->m_Callbacks);
+		}
+		for (auto& callback : callbacks)
+		{
+			callback(load->m_File);
+		}
 	}
+}
 
-	// File not found in cache, load it only once
-	FileBuffer& buffer = OS::LoadFileContents(path);
-	ResourceData* resData = new ResourceData(path, buffer);
-	LuaTextResourceFile* luaRes = new LuaTextResourceFile(resData);
+void ResourceLoader::WaitForAsyncLoads()
+{
+	Application::GetSingleton()->getThreadPool().wait(s_AsyncLoads);
+}
 
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(luaRes);
+void ResourceLoader::RegisterAPI(sol::table& rootex)
+{
+	sol::usertype<ResourceLoader> resourceLoader = rootex.new_usertype<ResourceLoader>("ResourceLoader");
+	resourceLoader["CreateAudio"] = &ResourceLoader::CreateAudioResourceFile;
+	resourceLoader["CreateFont"] = &ResourceLoader::CreateFontResourceFile;
+	resourceLoader["CreateImage"] = &ResourceLoader::CreateImageResourceFile;
+	resourceLoader["CreateLua"] = &ResourceLoader::CreateLuaTextResourceFile;
+	resourceLoader["CreateText"] = &ResourceLoader::CreateTextResourceFile;
+	resourceLoader["CreateNewText"] = &ResourceLoader::CreateNewTextResourceFile;
+	resourceLoader["CreateVisualModel"] = &ResourceLoader::CreateModelResourceFile;
+}
 
-	return luaRes;
+String ResourceLoader::NormalizePath(const String& path)
+{
+	return FilePath(path).lexically_normal().generic_string();
 }
 
-AudioResourceFile* ResourceLoader::CreateAudioResourceFile(const String& path)
+ResourceFile* ResourceLoader::LoadCached(const String& path, ResourceFile::Type type, const Function<ResourceFile*(const String&)>& loader)
 {
-	for (auto& item : s_ResourcesDataFiles)
+	String normalPath = NormalizePath(path);
+
+	Ref<CachedResource> cached;
 	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Audio)
+		std::unique_lock<std::mutex> lock(s_CacheMutex);
+		Ref<CachedResource>& entry = s_Cache[type][normalPath];
+		if (entry)
 		{
-			return reinterpret_cast<AudioResourceFile*>(item.second.get());
+			cached = entry;
+			s_LoadedVariable.wait(lock, [&cached]() { return cached->m_IsLoaded; });
+			return cached->m_File.get();
 		}
+		entry.reset(new CachedResource());
+		cached = entry;
 	}
 
-	if (OS::IsExists(path) == false)
+	// File not found in cache, load it only once. The cache is not locked so that other files can load meanwhile
+	ResourceFile* file = nullptr;
+	if (IsArchived(normalPath) || OS::IsExists(normalPath))
 	{
-		ERR("File not found: " + path);
-		return nullptr;
+		file = loader(normalPath);
+	}
+	else
+	{
+		ERR("File not found: " + normalPath);
 	}
 
-	// File not found in cache, load it only once
-	const char* audioBuffer;
-	int format;
-	int size;
-	float frequency;
-	ALUT_CHECK(audioBuffer = (const char*)alutLoadMemoryFromFile(
-	               OS::GetAbsolutePath(path).generic_string().c_str(),
-	               &format,
-	               &size,
-	               &frequency));
-
-	Vector<char> dataArray;
-	dataArray.insert(
-	    dataArray.begin(),
-	    audioBuffer,
-	    audioBuffer + size);
-	ResourceData* resData = new ResourceData(path, dataArray);
+	{
+		std::lock_guard<std::mutex> lock(s_CacheMutex);
+		if (file)
+		{
+			cached->m_Data.reset(file->m_ResourceData);
+			cached->m_File.reset(file);
+		}
+		else
+		{
+			// Let the next request try again, the file may have been created by then
+			s_Cache[type].erase(normalPath);
+		}
+		cached->m_IsLoaded = true;
+	}
+	s_LoadedVariable.notify_all();
 
-	AudioResourceFile* audioRes = new AudioResourceFile(resData);
-	LoadALUT(audioRes, audioBuffer, format, size, frequency);
+	return file;
+}
 
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(audioRes);
+bool ResourceLoader::Mount(const String& archivePath)
+{
+	Ptr<AssetArchive> archive = AssetArchive::Open(archivePath);
+	if (!archive)
+	{
+		return false;
+	}
 
-	return audioRes;
+	PRINT("Mounted " + std::to_string(archive->getEntryCount()) + " files from " + archivePath);
+	s_Archives.push_back(std::move(archive));
+	return true;
 }
 
-ModelResourceFile* ResourceLoader::CreateModelResourceFile(const String& path)
+AssetArchive* ResourceLoader::FindArchive(const String& normalPath, const AssetArchive::Entry*& entry)
 {
-	for (auto& item : s_ResourcesDataFiles)
+	for (auto archive = s_Archives.rbegin(); archive != s_Archives.rend(); archive++)
 	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Model)
+		entry = (*archive)->find(normalPath);
+		if (entry)
 		{
-			return reinterpret_cast<ModelResourceFile*>(item.second.get());
+			return archive->get();
 		}
 	}
+	return nullptr;
+}
 
-	if (OS::IsExists(path) == false)
+bool ResourceLoader::IsArchived(const String& path)
+{
+	const AssetArchive::Entry* entry = nullptr;
+	return FindArchive(NormalizePath(path), entry) != nullptr;
+}
+
+FileBuffer ResourceLoader::LoadFileContents(const String& normalPath)
+{
+	const AssetArchive::Entry* entry = nullptr;
+	if (AssetArchive* archive = FindArchive(normalPath, entry))
 	{
-		ERR("File not found: " + path);
-		return nullptr;
+		const char* data = archive->getData(entry);
+		return FileBuffer(data, data + entry->m_Size);
 	}
-	
-	FileBuffer& buffer = OS::LoadFileContents(path);
-	ResourceData* resData = new ResourceData(path, buffer);
-	ModelResourceFile* visualRes = new ModelResourceFile(resData);
-	
-	LoadAssimp(visualRes);
-
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(visualRes);
-
-	return visualRes;
+	return OS::LoadFileContents(normalPath);
 }
 
-ImageResourceFile* ResourceLoader::CreateImageResourceFile(const String& path)
+ResourceData* ResourceLoader::LoadResourceData(const String& path)
 {
-	for (auto& item : s_ResourcesDataFiles)
+	const AssetArchive::Entry* entry = nullptr;
+	if (AssetArchive* archive = FindArchive(path, entry))
+	{
+		return new ResourceData(path, archive->getMapping(), archive->getData(entry), entry->m_Size);
+	}
+
+#ifndef ROOTEX_EDITOR
+	// Windows can't replace a mapped file, which would stop the editor from hot reloading it
+	std::error_code error;
+	if (std::filesystem::file_size(OS::GetAbsolutePath(path), error) >= MAPPED_FILE_MIN_SIZE && !error)
 	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Image)
+		if (Ref<FileMapping> mapping = OS::MapFileContents(path))
 		{
-			return reinterpret_cast<ImageResourceFile*>(item.second.get());
+			return new ResourceData(path, mapping);
 		}
+		WARN("Could not map file, reading it instead: " + path);
 	}
+#endif // ROOTEX_EDITOR
+	return new ResourceData(path, OS::LoadFileContents(path));
+}
 
-	if (OS::IsExists(path) == false)
+Vector<ResourceFile*> ResourceLoader::GetResources()
+{
+	std::lock_guard<std::mutex> lock(s_CacheMutex);
+	Vector<ResourceFile*> resources;
+	for (auto& [type, files] : s_Cache)
 	{
-		ERR("File not found: " + path);
-		return nullptr;
+		for (auto& [path, cached] : files)
+		{
+			if (cached->m_File)
+			{
+				resources.push_back(cached->m_File.get());
+			}
+		}
 	}
+	return resources;
+}
 
-	// File not found in cache, load it only once
-	FileBuffer& buffer = OS::LoadFileContents(path);
-	ResourceData* resData = new ResourceData(path, buffer);
-	ImageResourceFile* imageRes = new ImageResourceFile(resData);
+TextResourceFile* ResourceLoader::CreateTextResourceFile(const String& path)
+{
+	return (TextResourceFile*)LoadCached(path, ResourceFile::Type::Text, [](const String& path) -> ResourceFile* {
+		return new TextResourceFile(ResourceFile::Type::Text, new ResourceData(path, LoadFileContents(path)));
+	});
+}
 
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(imageRes);
+TextResourceFile* ResourceLoader::CreateNewTextResourceFile(const String& path)
+{
+	if (!OS::IsExists(path))
+	{
+		OS::CreateFileName(path);
+	}
+	return CreateTextResourceFile(path);
+}
 
-	return imageRes;
+LuaTextResourceFile* ResourceLoader::CreateLuaTextResourceFile(const String& path)
+{
+	return (LuaTextResourceFile*)LoadCached(path, ResourceFile::Type::Lua, [](const String& path) -> ResourceFile* {
+		return new LuaTextResourceFile(new ResourceData(path, LoadFileContents(path)));
+	});
 }
 
-FontResourceFile* ResourceLoader::CreateFontResourceFile(const String& path)
+AudioResourceFile* ResourceLoader::CreateAudioResourceFile(const String& path)
 {
-	for (auto& item : s_ResourcesDataFiles)
-	{
-		if (item.first->getPath() == path && item.second->getType() == ResourceFile::Type::Font)
+	return (AudioResourceFile*)LoadCached(path, ResourceFile::Type::Audio, [](const String& path) -> ResourceFile* {
+		const char* audioBuffer;
+		int format;
+		int size;
+		float frequency;
+		const AssetArchive::Entry* entry = nullptr;
+		if (AssetArchive* archive = FindArchive(path, entry))
 		{
-			return reinterpret_cast<FontResourceFile*>(item.second.get());
+			ALUT_CHECK(audioBuffer = (const char*)alutLoadMemoryFromFileImage(
+			               archive->getData(entry),
+			               entry->m_Size,
+			               &format,
+			               &size,
+			               &frequency));
+		}
+		else
+		{
+			ALUT_CHECK(audioBuffer = (const char*)alutLoadMemoryFromFile(
+			               OS::GetAbsolutePath(path).generic_string().c_str(),
+			               &format,
+			               &size,
+			               &frequency));
 		}
-	}
 
-	if (OS::IsExists(path) == false)
-	{
-		ERR("File not found: " + path);
-		return nullptr;
-	}
+		Vector<char> dataArray;
+		dataArray.insert(
+		    dataArray.begin(),
+		    audioBuffer,
+		    audioBuffer + size);
+		ResourceData* resData = new ResourceData(path, std::move(dataArray));
+
+		AudioResourceFile* audioRes = new AudioResourceFile(resData);
+		LoadALUT(audioRes, audioBuffer, format, size, frequency);
+		return audioRes;
+	});
+}
 
-	// File not found in cache, load it only once
-	FileBuffer& buffer = OS::LoadFileContents(path);
-	ResourceData* resData = new ResourceData(path, buffer);
-	FontResourceFile* fontRes = new FontResourceFile(resData);
+ModelResourceFile* ResourceLoader::CreateModelResourceFile(const String& path)
+{
+	return (ModelResourceFile*)LoadCached(path, ResourceFile::Type::Model, [](const String& path) -> ResourceFile* {
+		// Assimp and the cooked model loader read the model files themselves, so mapping the source would only hold it open
+		ModelResourceFile* visualRes = new ModelResourceFile(new ResourceData(path, LoadFileContents(path)));
+		LoadModel(visualRes);
+		return visualRes;
+	});
+}
 
-	s_ResourcesDataFiles[Ptr<ResourceData>(resData)] = Ptr<ResourceFile>(fontRes);
+ImageResourceFile* ResourceLoader::CreateImageResourceFile(const String& path)
+{
+	return (ImageResourceFile*)LoadCached(path, ResourceFile::Type::Image, [](const String& path) -> ResourceFile* {
+		return new ImageResourceFile(LoadResourceData(path));
+	});
+}
 
-	return fontRes;
+FontResourceFile* ResourceLoader::CreateFontResourceFile(const String& path)
+{
+	return (FontResourceFile*)LoadCached(path, ResourceFile::Type::Font, [](const String& path) -> ResourceFile* {
+		return new FontResourceFile(LoadResourceData(path));
+	});
 }
 
 void ResourceLoader::SaveResourceFile(ResourceFile* resourceFile)
@@ -542,13 +881,27 @@ void ResourceLoader::SaveResourceFile(ResourceFile* resourceFile)
 
 void ResourceLoader::ReloadResourceData(const String& path)
 {
-	FileBuffer& buffer = OS::LoadFileContents(path);
+	String normalPath = NormalizePath(path);
 
-	for (auto&& [resData, resFile] : s_ResourcesDataFiles)
+	std::lock_guard<std::mutex> lock(s_CacheMutex);
+	for (auto& [type, files] : s_Cache)
 	{
-		if (resData->getPath() == path)
+		auto findIt = files.find(normalPath);
+		// Archives don't change while mounted
+		if (findIt == files.end() || !findIt->second->m_Data || IsArchived(normalPath))
 		{
-			*resData->getRawData() = buffer;
+			continue;
+		}
+
+		ResourceData* data = findIt->second->m_Data.get();
+		Ref<FileMapping> mapping = data->isMapped() ? OS::MapFileContents(normalPath) : nullptr;
+		if (mapping)
+		{
+			data->setMapping(mapping);
+		}
+		else
+		{
+			data->setBuffer(OS::LoadFileContents(normalPath));
 		}
 	}
 }
@@ -583,11 +936,7 @@ void ResourceLoader::Reload(AudioResourceFile* file)
 	               &format,
 	               &size,
 	               &frequency));
-	file->m_ResourceData->getRawData()->clear();
-	file->m_ResourceData->getRawData()->insert(
-	    file->m_ResourceData->getRawData()->begin(),
-	    audioBuffer,
-	    audioBuffer + size);
+	file->m_ResourceData->setBuffer(FileBuffer(audioBuffer, audioBuffer + size));
 
 	AudioResourceFile* audioRes = file;
 	LoadALUT(audioRes, audioBuffer, format, size, frequency);
@@ -597,7 +946,7 @@ void ResourceLoader::Reload(ModelResourceFile* file)
 {
 	UpdateFileTimes(file);
 	ReloadResourceData(file->getPath().string());
-	LoadAssimp(file);
+	LoadModel(file);
 }
 
 void ResourceLoader::Reload(ImageResourceFile* file)
@@ -631,46 +980,32 @@ int ResourceLoader::Preload(Vector<String> paths, Atomic<int>& progress)
 		}
 	}
 
-	ThreadPool& preloadThreads = Application::GetSingleton()->getThreadPool();
-	Vector<Ref<Task>> preloadTasks;
-
 	progress = 0;
 	for (auto& path : empericalPaths)
 	{
-		Ref<Task> loadingTask(new Task([=, &progress]() {
-			CreateSomeResourceFile(path);
-			progress++;
-		}));
-		preloadTasks.push_back(loadingTask);
+		StartLoad(path, GetResourceType(path), LoadPriority::Normal, &progress);
 	}
 
-	// FIX: This is a workaround which saves the main thread from being blocked when 1 task is submitted
-	preloadTasks.push_back(Ref<Task>(new Task([]() {})));
-
-	preloadThreads.submit(preloadTasks);
-
 	PRINT("Preloading " + std::to_string(paths.size()) + " resource files");
-	return preloadTasks.size() - 1; // 1 less for the dummy task
+	return empericalPaths.size();
 }
 
 void ResourceLoader::Unload(const Vector<String>& paths)
 {
-	Vector<const Ptr<ResourceData>*> unloads;
-	for (auto& [data, file] : s_ResourcesDataFiles)
+	std::lock_guard<std::mutex> lock(s_CacheMutex);
+	for (auto& path : paths)
 	{
-		for (auto& path : paths)
+		String normalPath = NormalizePath(path);
+		for (auto& [type, files] : s_Cache)
 		{
-			if (data->getPath() == path)
+			auto findIt = files.find(normalPath);
+			// Files still loading are left to finish
+			if (findIt != files.end() && findIt->second->m_IsLoaded)
 			{
-				unloads.push_back(&data);
+				files.erase(findIt);
 			}
 		}
 	}
 
-	for (auto& dataPtr : unloads)
-	{
-		s_ResourcesDataFiles.erase(*dataPtr);
-	}
-
 	PRINT("Unloaded " + std::to_string(paths.size()) + " resource files");
 }
@@ -1,14 +1,21 @@
 #pragma once
 
 #include "common/common.h"
+#include "core/asset_archive.h"
+#include "core/cooked_model.h"
 #include "core/resource_data.h"
 #include "core/resource_file.h"
 #include "os/os.h"
+#include "os/thread.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
 static const inline HashMap<ResourceFile::Type, Vector<String>> SupportedFiles = {
 	{
 	    ResourceFile::Type::Font,
@@ -42,22 +49,176 @@ static const inline HashMap<ResourceFile::Type, Vector<String>> SupportedFiles =
 
 bool IsFileSupported(const String& extension, ResourceFile::Type supportedFileType);
 
+/// Order in which asynchronous loads are picked up by the worker threads. Loads of the same priority are picked up in the order they were asked for.
+enum class LoadPriority : int
+{
+	/// Files that won't be needed for a while, like streamed in surroundings.
+	Low = 0,
+	Normal = 1,
+	/// Files that are needed as soon as possible.
+	High = 2
+};
+
+/// State of a single asynchronous load, shared by all handles to it.
+struct AsyncResourceLoad
+{
+	String m_Path;
+	ResourceFile::Type m_Type;
+	LoadPriority m_Priority;
+	/// Position in the order of loads of the same priority.
+	unsigned int m_Sequence = 0;
+	/// Set before m_Counter reaches 0. nullptr if loading failed.
+	ResourceFile* m_File = nullptr;
+	/// Reaches 0 when the load is done.
+	TaskCounter m_Counter;
+	/// Incremented on the loading thread when done, if set.
+	Atomic<int>* m_Progress = nullptr;
+
+	std::mutex m_CallbacksMutex;
+	/// Called on the main thread after the load is done.
+	Vector<Function<void(ResourceFile*)>> m_Callbacks;
+
+	AsyncResourceLoad(const String& path, ResourceFile::Type type, LoadPriority priority)
+	    : m_Path(path)
+	    , m_Type(type)
+	    , m_Priority(priority)
+	    , m_Counter(1)
+	{
+	}
+	AsyncResourceLoad(AsyncResourceLoad&) = delete;
+};
+
+/// Type of ResourceFile that ResourceLoader::LoadAsync<T>() creates for T.
+template <class T>
+struct ResourceTypeOf;
+template <>
+struct ResourceTypeOf<TextResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Text; };
+template <>
+struct ResourceTypeOf<LuaTextResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Lua; };
+template <>
+struct ResourceTypeOf<AudioResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Audio; };
+template <>
+struct ResourceTypeOf<ModelResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Model; };
+template <>
+struct ResourceTypeOf<ImageResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Image; };
+template <>
+struct ResourceTypeOf<FontResourceFile> { static const ResourceFile::Type Value = ResourceFile::Type::Font; };
+
+/// Refers to a file being loaded by ResourceLoader::LoadAsync(). Cheap to copy.
+template <class T>
+class ResourceHandle
+{
+	Ref<AsyncResourceLoad> m_Load;
+
+public:
+	ResourceHandle() = default;
+	ResourceHandle(const Ref<AsyncResourceLoad>& load)
+	    : m_Load(load)
+	{
+	}
+
+	/// If the handle refers to a load at all.
+	bool isValid() const { return m_Load != nullptr; }
+	/// If the load is done, whether it succeeded or not.
+	bool isReady() const { return m_Load && m_Load->m_Counter.isDone(); }
+	/// Returns nullptr until the load is done, or if it failed.
+	T* get() const { return isReady() ? static_cast<T*>(m_Load->m_File) : nullptr; }
+	/// Block until the load is done, running other pending tasks meanwhile. Returns nullptr if loading failed.
+	T* wait() const;
+	/// Call callback with the loaded file, or nullptr if loading failed, on the main thread once the load is done.
+	/// Callbacks run from ResourceLoader::DispatchCallbacks(), so they run a frame later even if the load was already done.
+	void then(const Function<void(T*)>& callback) const;
+
+	const String& getPath() const { return m_Load->m_Path; }
+};
+
 /// Factory for ResourceFile objects. Implements creating, loading and saving files.                                \n
 /// Maintains an internal cache that doesn't let the same file to be loaded twice. Cache misses force file loading. \n
 /// This just means you can load the same file multiple times without worrying about unnecessary copies.            \n
+/// The cache is safe to use from any thread. Threads asking for a file that is being loaded wait for that load.    \n
 /// All path arguments should be relative to Rootex root.
 class ResourceLoader
 {
-	static HashMap<Ptr<ResourceData>, Ptr<ResourceFile>> s_ResourcesDataFiles;
-	
+	/// Cache entry of a file. Created as soon as the file is asked for, filled in when its load finishes.
+	struct CachedResource
+	{
+		Ptr<ResourceData> m_Data;
+		Ptr<ResourceFile> m_File;
+		bool m_IsLoaded = false;
+	};
+
+	/// Mounted archives, searched from the last mounted to the first.
+	static Vector<Ptr<AssetArchive>> s_Archives;
+
+	/// Cached files by type and normalized path.
+	static HashMap<ResourceFile::Type, HashMap<String, Ref<CachedResource>>> s_Cache;
+	static std::mutex s_CacheMutex;
+	/// Notified when any load finishes.
+	static std::condition_variable s_LoadedVariable;
+
+	/// Same file can be asked for through differently written paths. Makes them all the same.
+	static String NormalizePath(const String& path);
+	/// Return the cached file or load it with loader, making sure only one thread loads it. Returns nullptr if loading failed.
+	static ResourceFile* LoadCached(const String& path, ResourceFile::Type type, const Function<ResourceFile*(const String&)>& loader);
+	/// Returns the archive having the file and sets entry, or returns nullptr if no mounted archive has the file.
+	static AssetArchive* FindArchive(const String& normalPath, const AssetArchive::Entry*& entry);
+	/// Copy the file out of the archives, or read it from disk if it is not archived.
+	static FileBuffer LoadFileContents(const String& normalPath);
+	/// Maps files of at least MAPPED_FILE_MIN_SIZE bytes and reads smaller ones. Used for files whose data is read from the ResourceData.
+	/// Editor builds always read, so that mapped files don't block saving over them.
+	static ResourceData* LoadResourceData(const String& path);
+
+	/// Orders pending asynchronous loads by priority, then by the order they were asked for.
+	struct AsyncLoadOrder
+	{
+		bool operator()(const Ref<AsyncResourceLoad>& a, const Ref<AsyncResourceLoad>& b) const
+		{
+			return a->m_Priority != b->m_Priority ? a->m_Priority < b->m_Priority : a->m_Sequence > b->m_Sequence;
+		}
+	};
+
+	static std::priority_queue<Ref<AsyncResourceLoad>, Vector<Ref<AsyncResourceLoad>>, AsyncLoadOrder> s_PendingLoads;
+	static std::mutex s_PendingLoadsMutex;
+	static unsigned int s_LoadSequence;
+	/// Counts the asynchronous loads that are not done yet.
+	static TaskCounter s_AsyncLoads;
+	/// Done loads whose callbacks are yet to be called.
+	static ConcurrentQueue<Ref<AsyncResourceLoad>> s_DoneLoads;
+
+	/// Run the most urgent pending load. A task running this is submitted for every load.
+	static void RunPendingLoad();
+	static Ref<AsyncResourceLoad> StartLoad(const String& path, ResourceFile::Type type, LoadPriority priority, Atomic<int>* progress = nullptr);
+
+	friend class ArchiveIOSystem;
+	template <class T>
+	friend class ResourceHandle;
+
+	static void WaitForLoad(AsyncResourceLoad& load);
+	static void AddCallback(const Ref<AsyncResourceLoad>& load, const Function<void(ResourceFile*)>& callback);
+
 	static void UpdateFileTimes(ResourceFile* file);
+	/// Import a model through Assimp, reading it out of the mounted archives if needed. Returns nullptr if the import failed.
+	static const aiScene* ImportAssimp(const String& path, Assimp::Importer& importer);
+	static void ExtractAssimpMesh(const aiMesh* mesh, CookedModel::MeshData& data);
+	/// Find or create the material file used by an imported material. Sets materialPath to the path of the material file.
+	static Ref<BasicMaterial> LoadAssimpMaterial(const FilePath& modelPath, const aiScene* scene, aiMaterial* material, Vector<Ref<Texture>>& textures, String& materialPath);
 	static void LoadAssimp(ModelResourceFile* file);
+	/// Returns false if the model has no up to date cooked model.
+	static bool LoadCookedModel(ModelResourceFile* file);
+	/// Load the cooked model if there is one, or import the model otherwise.
+	static void LoadModel(ModelResourceFile* file);
 	static void LoadALUT(AudioResourceFile* audioRes, const char* audioBuffer, int format, int size, float frequency);
 
 public:
 	static void RegisterAPI(sol::table& rootex);
 
-	static const HashMap<Ptr<ResourceData>, Ptr<ResourceFile>>& GetResources() { return s_ResourcesDataFiles; };
+	/// Files loaded so far. Files that are being loaded are left out.
+	static Vector<ResourceFile*> GetResources();
+
+	/// Look for files in the archive before looking for loose files. Call before any resources are loaded.
+	static bool Mount(const String& archivePath);
+	/// If a mounted archive has the file.
+	static bool IsArchived(const String& path);
 
 	static TextResourceFile* CreateTextResourceFile(const String& path);
 	static TextResourceFile* CreateNewTextResourceFile(const String& path);
@@ -67,8 +228,25 @@ public:
 	static ImageResourceFile* CreateImageResourceFile(const String& path);
 	static FontResourceFile* CreateFontResourceFile(const String& path);
 	
+	/// Import the model and write it to CookedModel::GetCookedPath(path), to be loaded instead of importing the model again.
+	static bool CookModel(const String& path);
+	/// Cook every model inside directory, recursively.
+	static void CookModels(const String& directory);
+
 	/// Use when you don't know what kind of a resource file will it be
 	static ResourceFile* CreateSomeResourceFile(const String& path);
+	/// Returns nullptr for ResourceFile::Type::None.
+	static ResourceFile* CreateResourceFile(ResourceFile::Type type, const String& path);
+	/// Type of resource file used for the file extension. ResourceFile::Type::None if the extension is not supported.
+	static ResourceFile::Type GetResourceType(const String& path);
+
+	/// Load the file on a worker thread. Files already loaded are ready right away.
+	template <class T>
+	static ResourceHandle<T> LoadAsync(const String& path, LoadPriority priority = LoadPriority::Normal);
+	/// Call the callbacks of the asynchronous loads done since the last call. Called once a frame by Application.
+	static void DispatchCallbacks();
+	/// Block until all asynchronous loads asked for so far are done, running other pending tasks meanwhile.
+	static void WaitForAsyncLoads();
 	
 	/// Write the data buffer inside a ResourceFile to disk.
 	static void SaveResourceFile(ResourceFile* resourceFile);
@@ -83,6 +261,26 @@ public:
 	static void Reload(FontResourceFile* file);
 
 	/// Load all the files passed in, in a parellel manner. Return total tasks generated.
+	/// progress is incremented as files finish loading, so it should live until WaitForAsyncLoads() returns.
 	static int Preload(Vector<String> paths, Atomic<int>& progress);
 	static void Unload(const Vector<String>& paths);
 };
+
+template <class T>
+inline ResourceHandle<T> ResourceLoader::LoadAsync(const String& path, LoadPriority priority)
+{
+	return ResourceHandle<T>(StartLoad(path, ResourceTypeOf<T>::Value, priority));
+}
+
+template <class T>
+inline T* ResourceHandle<T>::wait() const
+{
+	ResourceLoader::WaitForLoad(*m_Load);
+	return static_cast<T*>(m_Load->m_File);
+}
+
+template <class T>
+inline void ResourceHandle<T>::then(const Function<void(T*)>& callback) const
+{
+	ResourceLoader::AddCallback(m_Load, [callback](ResourceFile* file) { callback(static_cast<T*>(file)); });
+}
@@ -3,6 +3,7 @@
 #include "common/common.h"
 #include "script/interpreter.h"
 #include "components/component_ids.h"
+#include "pool_allocator.h"
 
 typedef unsigned int ComponentID;
 
@@ -12,11 +13,20 @@ class Component
 	void setOwner(Ref<Entity>& newOwner) { m_Owner = newOwner; }
 	friend class EntityFactory;
 
+	/// Position of this component in the System component list of its type. -1 if not registered.
+	int m_SystemIndex;
+	friend class System;
+
 protected:
 	Ref<Entity> m_Owner;
 	
 public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::Component;
+	/// Set by components that implement clone(). Read by EntityFactory when registering the component, so that prefabs
+	/// construct prototypes only of components that can be cloned.
+	static const bool s_IsCloneable = false;
+
+	POOL_ALLOCATED_CLASS
 
 	Component();
 	virtual ~Component();
@@ -30,10 +40,15 @@ public:
 	virtual void onTrigger();
 
 	Ref<Entity> getOwner() const;
+	/// Owner without touching the reference count. nullptr until the component is added to an entity.
+	Entity* getOwnerPointer() const { return m_Owner.get(); }
 	virtual ComponentID getComponentID() const = 0;
 	virtual String getName() const = 0;
 	/// Get JSON representation of the component data needed to re-construct component from memory.
 	virtual JSON::json getJSON() const;
+	/// Create an unregistered copy of this component as it was before setup(), so that prefabs can spawn it without reading its JSON data again.
+	/// Returns nullptr if the component can only be created from its JSON data.
+	virtual Component* clone() const { return nullptr; }
 
 #ifdef ROOTEX_EDITOR
 	/// Expose the component data in the InspectorDock.
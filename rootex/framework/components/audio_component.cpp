@@ -7,6 +7,7 @@ AudioComponent::AudioComponent(bool playOnStart, bool attenuation, AudioSource::
     , m_RolloffFactor(rolloffFactor)
     , m_ReferenceDistance(referenceDistance)
     , m_MaxDistance(maxDistance)
+    , m_Position(0.0f, 0.0f, 0.0f)
     , m_TransformComponent(nullptr)
 {
 }
@@ -50,12 +51,19 @@ JSON::json AudioComponent::getJSON() const
 	return j;
 }
 
+void AudioComponent::updatePosition()
+{
+	if (TransformComponent* transform = m_Owner->getComponentPointer<TransformComponent>())
+	{
+		m_Position = transform->getAbsoluteTransform().Translation();
+	}
+}
+
 void AudioComponent::update()
 {
-	m_TransformComponent = m_Owner->getComponent<TransformComponent>().get();
 	if (m_IsAttenuated)
 	{
-		getAudioSource()->setPosition(m_TransformComponent->getAbsoluteTransform().Translation());
+		getAudioSource()->setPosition(m_Position);
 	}
 }
 
@@ -14,6 +14,8 @@ private:
 	ALfloat m_ReferenceDistance;
 	ALfloat m_MaxDistance;
 	AudioSource* m_AudioSource;
+	/// World position of the source, copied from the transform by updatePosition().
+	Vector3 m_Position;
 
 protected:
 	bool m_IsPlayOnStart;
@@ -32,6 +34,9 @@ public:
 
 	virtual bool setup() override;
 
+	/// Copy the world position out of the transform. Doesn't call into OpenAL, so it can run on a worker thread.
+	void updatePosition();
+	/// Hand the position copied by updatePosition() to OpenAL.
 	void update();
 
 	bool isPlayOnStart() const { return m_IsPlayOnStart; }
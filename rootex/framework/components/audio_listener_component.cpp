@@ -16,6 +16,7 @@ Component* AudioListenerComponent::CreateDefault()
 
 AudioListenerComponent::AudioListenerComponent()
     : m_TransformComponent(nullptr)
+    , m_Position(0.0f, 0.0f, 0.0f)
 {
 }
 
@@ -45,7 +46,10 @@ void AudioListenerComponent::onRemove()
 	}
 }
 
-Vector3 AudioListenerComponent::getPosition() const
+void AudioListenerComponent::updatePosition()
 {
-	return m_TransformComponent->getAbsoluteTransform().Translation();
+	if (m_TransformComponent)
+	{
+		m_Position = m_TransformComponent->getAbsoluteTransform().Translation();
+	}
 }
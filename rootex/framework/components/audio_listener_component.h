@@ -14,6 +14,8 @@ class AudioListenerComponent : public Component
 	friend class EntityFactory;
 
 	TransformComponent* m_TransformComponent;
+	/// World position copied from the transform by updatePosition().
+	Vector3 m_Position;
 
 	AudioListenerComponent();
 	AudioListenerComponent(const AudioListenerComponent&) = delete;
@@ -25,7 +27,10 @@ public:
 	bool setup() override;
 	void onRemove() override;
 
-	Vector3 getPosition() const;
+	/// Copy the world position out of the transform. Doesn't call into OpenAL, so it can run on a worker thread.
+	void updatePosition();
+	/// Position copied by the last updatePosition().
+	const Vector3& getPosition() const { return m_Position; }
 
 	virtual String getName() const override { return "AudioListenerComponent"; }
 	ComponentID getComponentID() const { return s_ID; }
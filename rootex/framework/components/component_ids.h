@@ -30,4 +30,11 @@ enum class ComponentIDs : unsigned int
 	SkyComponent,
 	FogComponent,
 	StaticPointLightComponent,
+	/// Number of distinct component IDs. Keep last.
+	ComponentIDCount
 };
+
+/// Upper bound on the number of distinct component IDs.
+#define MAX_COMPONENT_IDS 64
+
+static_assert((unsigned int)ComponentIDs::ComponentIDCount <= MAX_COMPONENT_IDS, "Entity component slots cannot index every ComponentID");
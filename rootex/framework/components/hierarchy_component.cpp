@@ -1,6 +1,7 @@
 #include "hierarchy_component.h"
 #include "entity_factory.h"
 #include "event_manager.h"
+#include "transform_hierarchy.h"
 
 Component* HierarchyComponent::Create(const JSON::json& componentData)
 {
@@ -31,24 +32,91 @@ HierarchyComponent::HierarchyComponent(EntityID parentID, const Vector<EntityID>
     : m_ParentID(parentID)
     , m_ChildrenIDs(childrenIDs)
     , m_Parent(nullptr)
+    , m_FirstChild(nullptr)
+    , m_LastChild(nullptr)
+    , m_PreviousSibling(nullptr)
+    , m_NextSibling(nullptr)
+    , m_ChildCount(0)
 {
 }
 
+void HierarchyComponent::attach(HierarchyComponent* child)
+{
+	child->detach();
+
+	child->m_Parent = this;
+	child->m_ParentID = m_Owner->getID();
+	child->m_PreviousSibling = m_LastChild;
+	child->m_NextSibling = nullptr;
+	if (m_LastChild)
+	{
+		m_LastChild->m_NextSibling = child;
+	}
+	else
+	{
+		m_FirstChild = child;
+	}
+	m_LastChild = child;
+	m_ChildCount++;
+
+	TransformHierarchy::MarkStructureDirty();
+}
+
+void HierarchyComponent::detach()
+{
+	if (!m_Parent)
+	{
+		return;
+	}
+
+	if (m_PreviousSibling)
+	{
+		m_PreviousSibling->m_NextSibling = m_NextSibling;
+	}
+	else
+	{
+		m_Parent->m_FirstChild = m_NextSibling;
+	}
+	if (m_NextSibling)
+	{
+		m_NextSibling->m_PreviousSibling = m_PreviousSibling;
+	}
+	else
+	{
+		m_Parent->m_LastChild = m_PreviousSibling;
+	}
+	m_Parent->m_ChildCount--;
+
+	m_Parent = nullptr;
+	m_PreviousSibling = nullptr;
+	m_NextSibling = nullptr;
+
+	TransformHierarchy::MarkStructureDirty();
+}
+
 bool HierarchyComponent::addChild(Ref<Entity> child)
 {
-	if (auto&& findIt = std::find(m_ChildrenIDs.begin(), m_ChildrenIDs.end(), child->getID()) == m_ChildrenIDs.end())
+	HierarchyComponent* childHC = child->getComponentPointer<HierarchyComponent>();
+	if (childHC->m_Parent == this)
 	{
-		m_Children.push_back(child->getComponent<HierarchyComponent>().get());
-		m_ChildrenIDs.push_back(child->getID());
-		child->getComponent<HierarchyComponent>()->m_Parent = this;
-		child->getComponent<HierarchyComponent>()->m_ParentID = this->m_Owner->getID();
-		return true;
+		return false;
 	}
-	return false;
+	for (HierarchyComponent* ancestor = this; ancestor; ancestor = ancestor->m_Parent)
+	{
+		if (ancestor == childHC)
+		{
+			WARN("Cannot make " + child->getFullName() + " a child of its own descendant " + m_Owner->getFullName());
+			return false;
+		}
+	}
+
+	attach(childHC);
+	return true;
 }
 
 bool HierarchyComponent::setupEntities()
 {
+	TransformHierarchy::MarkStructureDirty();
 	if (m_Owner->getID() != ROOT_ENTITY_ID)
 	{
 		Ref<Entity> parent = EntityFactory::GetSingleton()->findEntity(m_ParentID);
@@ -57,19 +125,13 @@ bool HierarchyComponent::setupEntities()
 			ERR("Could not find Entity with ID " + std::to_string(m_ParentID));
 			return false;
 		}
-		m_Parent = parent->getComponent<HierarchyComponent>().get();
-		if (m_ParentID == ROOT_ENTITY_ID)
+		HierarchyComponent* parentHC = parent->getComponentPointer<HierarchyComponent>();
+		if (m_Parent != parentHC)
 		{
-			Ref<Entity> root = EntityFactory::GetSingleton()->findEntity(ROOT_ENTITY_ID);
-			if (!root)
-			{
-				ERR("Could not find root Entity");
-				return false;
-			}
-			Ref<HierarchyComponent> rootHC = root->getComponent<HierarchyComponent>();
-			rootHC->m_ChildrenIDs.push_back(m_Owner->getID());
-			rootHC->m_Children.push_back(m_Owner->getComponent<HierarchyComponent>().get());
+			parentHC->attach(this);
 		}
+
+		// Children that linked themselves already are appended again to keep the order of the entity file
 		for (EntityID childID : m_ChildrenIDs)
 		{
 			Ref<Entity> child = EntityFactory::GetSingleton()->findEntity(childID);
@@ -78,31 +140,27 @@ bool HierarchyComponent::setupEntities()
 				ERR("Could not find Entity with ID " + std::to_string(childID));
 				return false;
 			}
-			m_Children.push_back(child->getComponent<HierarchyComponent>().get());
+			attach(child->getComponentPointer<HierarchyComponent>());
 		}
 	}
 	else
 	{
-		m_Children.clear();
-		m_ChildrenIDs.clear();
+		while (m_FirstChild)
+		{
+			m_FirstChild->detach();
+		}
 	}
+	m_ChildrenIDs.clear();
 	return true;
 }
 
 bool HierarchyComponent::removeChild(Ref<Entity> node)
 {
-	auto& findIt = std::find(m_ChildrenIDs.begin(), m_ChildrenIDs.end(), node->getID());
-	if (findIt != m_ChildrenIDs.end())
+	HierarchyComponent* hc = node->getComponentPointer<HierarchyComponent>();
+	if (hc->m_Parent == this)
 	{
-		Ref<HierarchyComponent> hc = node->getComponent<HierarchyComponent>();
-		hc->m_Parent = nullptr;
+		hc->detach();
 		hc->m_ParentID = INVALID_ID;
-
-		auto&& findItPtr = std::find(m_Children.begin(), m_Children.end(), hc.get());
-
-		m_Children.erase(findItPtr);
-		m_ChildrenIDs.erase(findIt);
-
 		return true;
 	}
 	return false;
@@ -110,51 +168,66 @@ bool HierarchyComponent::removeChild(Ref<Entity> node)
 
 bool HierarchyComponent::snatchChild(Ref<Entity> node)
 {
-	node->getComponent<HierarchyComponent>()->getParent()->removeChild(node);
-	bool status = addChild(node);
-
-	return status;
+	if (node->getComponentPointer<HierarchyComponent>()->m_Parent == this)
+	{
+		return true;
+	}
+	return addChild(node);
 }
 
 void HierarchyComponent::clear()
 {
-	m_Parent = nullptr;
+	while (m_FirstChild)
+	{
+		m_FirstChild->detach();
+	}
+	detach();
 	m_ParentID = INVALID_ID;
-	m_Children.clear();
 	m_ChildrenIDs.clear();
+	TransformHierarchy::MarkStructureDirty();
 }
 
 void HierarchyComponent::onRemove()
 {
-	Vector<HierarchyComponent*> backup = m_Children;
-	for (auto& child : backup)
+	// Children move up to the parent, keeping their order
+	while (m_FirstChild)
 	{
 		if (m_Parent)
 		{
-			m_Parent->snatchChild(child->getOwner());
+			m_Parent->attach(m_FirstChild);
+		}
+		else
+		{
+			m_FirstChild->detach();
 		}
 	}
-	if (m_Parent)
+	detach();
+}
+
+Vector<HierarchyComponent*> HierarchyComponent::getChildren() const
+{
+	Vector<HierarchyComponent*> children;
+	children.reserve(m_ChildCount);
+	for (HierarchyComponent* child = m_FirstChild; child; child = child->m_NextSibling)
 	{
-		m_Parent->removeChild(m_Owner);
+		children.push_back(child);
 	}
+	return children;
 }
 
 JSON::json HierarchyComponent::getJSON() const
 {
 	JSON::json j;
 
-	if (m_Parent)
+	Vector<EntityID> childrenIDs;
+	for (HierarchyComponent* child = m_FirstChild; child; child = child->m_NextSibling)
 	{
-		j["parent"] = m_Parent->getOwner()->getID();
-		j["children"] = m_ChildrenIDs;
-	}
-	else
-	{
-		j["parent"] = INVALID_ID;
-		j["children"] = m_ChildrenIDs;
+		childrenIDs.push_back(child->getOwner()->getID());
 	}
 
+	j["parent"] = m_Parent ? m_Parent->getOwner()->getID() : INVALID_ID;
+	j["children"] = childrenIDs;
+
 	return j;
 }
 
@@ -167,7 +240,7 @@ void HierarchyComponent::draw()
 	{
 		if (ImGui::BeginCombo("##Parent", parentName.c_str(), ImGuiComboFlags_HeightLarge))
 		{
-			for (auto&& [entityID, entity] : EntityFactory::GetSingleton()->getEntities())
+			for (auto&& entity : EntityFactory::GetSingleton()->getEntities())
 			{
 				if (ImGui::Selectable(entity->getFullName().c_str()))
 				{
@@ -184,9 +257,9 @@ void HierarchyComponent::draw()
 		}
 	}
 
-	if (ImGui::ListBoxHeader("Children", m_Children.size() ? m_Children.size() : 1))
+	if (ImGui::ListBoxHeader("Children", m_ChildCount ? m_ChildCount : 1))
 	{
-		for (auto&& child : m_Children)
+		for (HierarchyComponent* child = m_FirstChild; child; child = child->m_NextSibling)
 		{
 			if (ImGui::Selectable(child->getOwner()->getFullName().c_str()))
 			{
@@ -11,10 +11,22 @@ protected:
 	static Component* CreateDefault();
 
 	EntityID m_ParentID;
+	/// Children read from the entity file, linked in setupEntities().
 	Vector<EntityID> m_ChildrenIDs;
 
-	Vector<HierarchyComponent*> m_Children;
+	/// Children form a doubly linked list threaded through the children themselves,
+	/// so that attaching and detaching never search or shift a list.
 	HierarchyComponent* m_Parent;
+	HierarchyComponent* m_FirstChild;
+	HierarchyComponent* m_LastChild;
+	HierarchyComponent* m_PreviousSibling;
+	HierarchyComponent* m_NextSibling;
+	unsigned int m_ChildCount;
+
+	/// Append child to the children, detaching it from its current parent first. O(1).
+	void attach(HierarchyComponent* child);
+	/// Unlink from the parent. O(1).
+	void detach();
 
 	friend class EntityFactory;
 	friend class HierarchySystem;
@@ -37,7 +49,14 @@ public:
 	virtual String getName() const override { return "HierarchyComponent"; }
 	ComponentID getComponentID() const { return s_ID; }
 	HierarchyComponent* getParent() const { return m_Parent; }
-	const Vector<HierarchyComponent*>& getChildren() const { return m_Children; }
+	/// Children are visited with getFirstChild() and getNextSibling(), in the order they were added.
+	HierarchyComponent* getFirstChild() const { return m_FirstChild; }
+	HierarchyComponent* getLastChild() const { return m_LastChild; }
+	HierarchyComponent* getPreviousSibling() const { return m_PreviousSibling; }
+	HierarchyComponent* getNextSibling() const { return m_NextSibling; }
+	unsigned int getChildCount() const { return m_ChildCount; }
+	/// Copies the children into a list. Prefer walking the siblings.
+	Vector<HierarchyComponent*> getChildren() const;
 	virtual JSON::json getJSON() const override;
 
 #ifdef ROOTEX_EDITOR
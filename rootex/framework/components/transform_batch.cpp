@@ -0,0 +1,183 @@
+#include "transform_batch.h"
+
+#ifdef ROOTEX_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+void TransformArrays::push(const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+{
+	m_PositionX.push_back(position.x);
+	m_PositionY.push_back(position.y);
+	m_PositionZ.push_back(position.z);
+	m_RotationX.push_back(rotation.x);
+	m_RotationY.push_back(rotation.y);
+	m_RotationZ.push_back(rotation.z);
+	m_RotationW.push_back(rotation.w);
+	m_ScaleX.push_back(scale.x);
+	m_ScaleY.push_back(scale.y);
+	m_ScaleZ.push_back(scale.z);
+}
+
+void TransformArrays::clear()
+{
+	m_PositionX.clear();
+	m_PositionY.clear();
+	m_PositionZ.clear();
+	m_RotationX.clear();
+	m_RotationY.clear();
+	m_RotationZ.clear();
+	m_RotationW.clear();
+	m_ScaleX.clear();
+	m_ScaleY.clear();
+	m_ScaleZ.clear();
+}
+
+/// Same layout as DirectX::XMMatrixRotationQuaternion(), with rows scaled and translation in the last row.
+static void ComposeScalar(float px, float py, float pz, float qx, float qy, float qz, float qw, float sx, float sy, float sz, Matrix& result)
+{
+	float xx = qx * qx;
+	float yy = qy * qy;
+	float zz = qz * qz;
+	float xy = qx * qy;
+	float xz = qx * qz;
+	float yz = qy * qz;
+	float xw = qx * qw;
+	float yw = qy * qw;
+	float zw = qz * qw;
+
+	result.m[0][0] = sx * (1.0f - 2.0f * (yy + zz));
+	result.m[0][1] = sx * (2.0f * (xy + zw));
+	result.m[0][2] = sx * (2.0f * (xz - yw));
+	result.m[0][3] = 0.0f;
+
+	result.m[1][0] = sy * (2.0f * (xy - zw));
+	result.m[1][1] = sy * (1.0f - 2.0f * (xx + zz));
+	result.m[1][2] = sy * (2.0f * (yz + xw));
+	result.m[1][3] = 0.0f;
+
+	result.m[2][0] = sz * (2.0f * (xz + yw));
+	result.m[2][1] = sz * (2.0f * (yz - xw));
+	result.m[2][2] = sz * (1.0f - 2.0f * (xx + yy));
+	result.m[2][3] = 0.0f;
+
+	result.m[3][0] = px;
+	result.m[3][1] = py;
+	result.m[3][2] = pz;
+	result.m[3][3] = 1.0f;
+}
+
+void TransformBatch::Compose(const TransformArrays& transforms, Matrix* results)
+{
+	size_t count = transforms.size();
+	size_t i = 0;
+
+#ifdef ROOTEX_TRANSFORM_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 qx = _mm_loadu_ps(&transforms.m_RotationX[i]);
+		__m128 qy = _mm_loadu_ps(&transforms.m_RotationY[i]);
+		__m128 qz = _mm_loadu_ps(&transforms.m_RotationZ[i]);
+		__m128 qw = _mm_loadu_ps(&transforms.m_RotationW[i]);
+		__m128 sx = _mm_loadu_ps(&transforms.m_ScaleX[i]);
+		__m128 sy = _mm_loadu_ps(&transforms.m_ScaleY[i]);
+		__m128 sz = _mm_loadu_ps(&transforms.m_ScaleZ[i]);
+
+		__m128 xx = _mm_mul_ps(qx, qx);
+		__m128 yy = _mm_mul_ps(qy, qy);
+		__m128 zz = _mm_mul_ps(qz, qz);
+		__m128 xy = _mm_mul_ps(qx, qy);
+		__m128 xz = _mm_mul_ps(qx, qz);
+		__m128 yz = _mm_mul_ps(qy, qz);
+		__m128 xw = _mm_mul_ps(qx, qw);
+		__m128 yw = _mm_mul_ps(qy, qw);
+		__m128 zw = _mm_mul_ps(qz, qw);
+
+		// Each register holds one matrix element of 4 transforms. Transposing turns them into rows of 4 matrices.
+		__m128 row0[4] = {
+			_mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)))),
+			_mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, zw))),
+			_mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, yw))),
+			zero
+		};
+		__m128 row1[4] = {
+			_mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, zw))),
+			_mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)))),
+			_mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, xw))),
+			zero
+		};
+		__m128 row2[4] = {
+			_mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, yw))),
+			_mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, xw))),
+			_mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))),
+			zero
+		};
+		__m128 row3[4] = {
+			_mm_loadu_ps(&transforms.m_PositionX[i]),
+			_mm_loadu_ps(&transforms.m_PositionY[i]),
+			_mm_loadu_ps(&transforms.m_PositionZ[i]),
+			one
+		};
+
+		_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+		_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+		_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+		_MM_TRANSPOSE4_PS(row3[0], row3[1], row3[2], row3[3]);
+
+		for (int j = 0; j < 4; j++)
+		{
+			_mm_storeu_ps(results[i + j].m[0], row0[j]);
+			_mm_storeu_ps(results[i + j].m[1], row1[j]);
+			_mm_storeu_ps(results[i + j].m[2], row2[j]);
+			_mm_storeu_ps(results[i + j].m[3], row3[j]);
+		}
+	}
+#endif // ROOTEX_TRANSFORM_SSE
+
+	for (; i < count; i++)
+	{
+		ComposeScalar(
+		    transforms.m_PositionX[i], transforms.m_PositionY[i], transforms.m_PositionZ[i],
+		    transforms.m_RotationX[i], transforms.m_RotationY[i], transforms.m_RotationZ[i], transforms.m_RotationW[i],
+		    transforms.m_ScaleX[i], transforms.m_ScaleY[i], transforms.m_ScaleZ[i],
+		    results[i]);
+	}
+}
+
+void TransformBatch::Compose(const Vector3& position, const Quaternion& rotation, const Vector3& scale, Matrix& result)
+{
+	ComposeScalar(position.x, position.y, position.z, rotation.x, rotation.y, rotation.z, rotation.w, scale.x, scale.y, scale.z, result);
+}
+
+void TransformBatch::Multiply(const Matrix& local, const Matrix& parent, Matrix& result)
+{
+#ifdef ROOTEX_TRANSFORM_SSE
+	__m128 parentRows[4] = {
+		_mm_loadu_ps(parent.m[0]),
+		_mm_loadu_ps(parent.m[1]),
+		_mm_loadu_ps(parent.m[2]),
+		_mm_loadu_ps(parent.m[3])
+	};
+	for (int row = 0; row < 4; row++)
+	{
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(local.m[row][0]), parentRows[0]);
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(local.m[row][1]), parentRows[1]));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(local.m[row][2]), parentRows[2]));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(local.m[row][3]), parentRows[3]));
+		_mm_storeu_ps(result.m[row], sum);
+	}
+#else
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			result.m[row][column] = local.m[row][0] * parent.m[0][column]
+			    + local.m[row][1] * parent.m[1][column]
+			    + local.m[row][2] * parent.m[2][column]
+			    + local.m[row][3] * parent.m[3][column];
+		}
+	}
+#endif // ROOTEX_TRANSFORM_SSE
+}
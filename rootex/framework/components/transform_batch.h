@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/common.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+/// Defined when the transform kernels can use SSE. Otherwise they fall back to scalar code.
+#define ROOTEX_TRANSFORM_SSE
+#endif
+
+/// Positions, rotations and scales of several transforms laid out as one array per component.
+struct TransformArrays
+{
+	Vector<float> m_PositionX;
+	Vector<float> m_PositionY;
+	Vector<float> m_PositionZ;
+	Vector<float> m_RotationX;
+	Vector<float> m_RotationY;
+	Vector<float> m_RotationZ;
+	Vector<float> m_RotationW;
+	Vector<float> m_ScaleX;
+	Vector<float> m_ScaleY;
+	Vector<float> m_ScaleZ;
+
+	void push(const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+	void clear();
+	size_t size() const { return m_PositionX.size(); }
+};
+
+/// Kernels that work on many transforms at once.
+class TransformBatch
+{
+public:
+	/// Build scale * rotation * translation matrices, 4 transforms at a time where SSE is available.
+	static void Compose(const TransformArrays& transforms, Matrix* results);
+	/// Compose a single transform. Gives the same result as Compose().
+	static void Compose(const Vector3& position, const Quaternion& rotation, const Vector3& scale, Matrix& result);
+	/// result = local * parent. result may not alias local or parent.
+	static void Multiply(const Matrix& local, const Matrix& parent, Matrix& result);
+};
@@ -4,6 +4,10 @@
 #include <math.h>
 
 #include "entity.h"
+#include "transform_hierarchy.h"
+#include "transform_batch.h"
+
+PackedStorage<TransformComponent::TransformBuffer, TransformComponent> TransformComponent::s_PackedTransforms;
 
 Component* TransformComponent::Create(const JSON::json& componentData)
 {
@@ -23,6 +27,16 @@ Component* TransformComponent::Create(const JSON::json& componentData)
 	return transformComponent;
 }
 
+Component* TransformComponent::clone() const
+{
+	const Quaternion& rotation = m_PackedData->m_Rotation;
+	return new TransformComponent(
+	    m_PackedData->m_Position,
+	    { rotation.x, rotation.y, rotation.z, rotation.w },
+	    m_PackedData->m_Scale,
+	    m_PackedData->m_BoundingBox);
+}
+
 Component* TransformComponent::CreateDefault()
 {
 	TransformComponent* transformComponent = new TransformComponent(
@@ -35,31 +49,106 @@ Component* TransformComponent::CreateDefault()
 
 void TransformComponent::updateTransformFromPositionRotationScale()
 {
-	m_TransformBuffer.m_Transform = Matrix::Identity;
-	m_TransformBuffer.m_Transform = Matrix::CreateTranslation(m_TransformBuffer.m_Position) * m_TransformBuffer.m_Transform;
-	m_TransformBuffer.m_Transform = Matrix::CreateFromQuaternion(m_TransformBuffer.m_Rotation) * m_TransformBuffer.m_Transform;
-	m_TransformBuffer.m_Transform = Matrix::CreateScale(m_TransformBuffer.m_Scale) * m_TransformBuffer.m_Transform;
+	// Composed in a batch by TransformHierarchy
+	m_PackedData->m_IsLocalDirty = true;
+	markDirty();
 }
 
 void TransformComponent::updatePositionRotationScaleFromTransform(Matrix& transform)
 {
-	transform.Decompose(m_TransformBuffer.m_Scale, m_TransformBuffer.m_Rotation, m_TransformBuffer.m_Position);
+	transform.Decompose(m_PackedData->m_Scale, m_PackedData->m_Rotation, m_PackedData->m_Position);
+	m_PackedData->m_IsLocalDirty = false;
+	markDirty();
+}
+
+Matrix TransformComponent::getLocalTransform() const
+{
+	if (m_PackedData->m_IsLocalDirty)
+	{
+		Matrix local;
+		TransformBatch::Compose(m_PackedData->m_Position, m_PackedData->m_Rotation, m_PackedData->m_Scale, local);
+		return local;
+	}
+	return m_PackedData->m_Transform;
+}
+
+Matrix TransformComponent::getAbsoluteTransform() const
+{
+	if (m_IsAbsoluteStale)
+	{
+		Matrix absolute;
+		TransformBatch::Multiply(getLocalTransform(), m_ParentAbsoluteTransform, absolute);
+		return absolute;
+	}
+	return m_AbsoluteTransform;
+}
+
+Matrix TransformComponent::getRotationPosition() const
+{
+	if (m_IsAbsoluteStale)
+	{
+		Matrix rotationPosition;
+		TransformBatch::Compose(m_PackedData->m_Position, m_PackedData->m_Rotation, Vector3::One, rotationPosition);
+		return rotationPosition * m_ParentAbsoluteTransform;
+	}
+	return m_RotationPosition;
+}
+
+void TransformComponent::refreshCaches()
+{
+	if (m_PackedData->m_IsLocalDirty)
+	{
+		TransformBatch::Compose(m_PackedData->m_Position, m_PackedData->m_Rotation, m_PackedData->m_Scale, m_PackedData->m_Transform);
+		m_PackedData->m_IsLocalDirty = false;
+	}
+	if (m_IsAbsoluteStale)
+	{
+		TransformBatch::Multiply(m_PackedData->m_Transform, m_ParentAbsoluteTransform, m_AbsoluteTransform);
+		TransformBatch::Compose(m_PackedData->m_Position, m_PackedData->m_Rotation, Vector3::One, m_RotationPosition);
+		m_RotationPosition *= m_ParentAbsoluteTransform;
+		m_IsAbsoluteStale = false;
+	}
+}
+
+void TransformComponent::setParentAbsoluteTransform(const Matrix& parentAbsoluteTransform)
+{
+	m_ParentAbsoluteTransform = parentAbsoluteTransform;
+	m_IsAbsoluteStale = true;
+	m_Version++;
+}
+
+void TransformComponent::markDirty()
+{
+	m_IsDirty = true;
+	m_IsAbsoluteStale = true;
+	m_Version++;
+	TransformHierarchy::MarkTransformDirty();
 }
 
 TransformComponent::TransformComponent(const Vector3& position, const Vector4& rotation, const Vector3& scale, const BoundingBox& bounds)
 {
-	m_TransformBuffer.m_Position = position;
-	m_TransformBuffer.m_Rotation = rotation;
-	m_TransformBuffer.m_Scale = scale;
-	m_TransformBuffer.m_BoundingBox = bounds;
+	TransformBuffer buffer;
+	buffer.m_Position = position;
+	buffer.m_Rotation = rotation;
+	buffer.m_Scale = scale;
+	buffer.m_BoundingBox = bounds;
+	buffer.m_IsLocalDirty = true;
+	s_PackedTransforms.add(this, buffer);
 
 	updateTransformFromPositionRotationScale();
+	TransformHierarchy::MarkStructureDirty();
 
 #ifdef ROOTEX_EDITOR
 	m_EditorRotation = { 0.0f, 0.0f, 0.0f };
 #endif // ROOTEX_EDITOR
 }
 
+TransformComponent::~TransformComponent()
+{
+	s_PackedTransforms.remove(this);
+	TransformHierarchy::MarkStructureDirty();
+}
+
 void TransformComponent::RegisterAPI(sol::table& rootex)
 {
 	sol::usertype<TransformComponent> transformComponent = rootex.new_usertype<TransformComponent>(
@@ -83,43 +172,43 @@ void TransformComponent::RegisterAPI(sol::table& rootex)
 
 void TransformComponent::setPosition(const Vector3& position)
 {
-	m_TransformBuffer.m_Position = position;
+	m_PackedData->m_Position = position;
 	updateTransformFromPositionRotationScale();
 }
 
 void TransformComponent::setRotation(const float& yaw, const float& pitch, const float& roll)
 {
-	m_TransformBuffer.m_Rotation = Quaternion::CreateFromYawPitchRoll(yaw, pitch, roll);
+	m_PackedData->m_Rotation = Quaternion::CreateFromYawPitchRoll(yaw, pitch, roll);
 	updateTransformFromPositionRotationScale();
 }
 
 void TransformComponent::setRotationQuaternion(const Quaternion& rotation)
 {
-	m_TransformBuffer.m_Rotation = rotation;
+	m_PackedData->m_Rotation = rotation;
 	updateTransformFromPositionRotationScale();
 }
 
 void TransformComponent::setScale(const Vector3& scale)
 {
-	m_TransformBuffer.m_Scale = scale;
+	m_PackedData->m_Scale = scale;
 	updateTransformFromPositionRotationScale();
 }
 
 void TransformComponent::setTransform(const Matrix& transform)
 {
-	m_TransformBuffer.m_Transform = transform;
-	updatePositionRotationScaleFromTransform(m_TransformBuffer.m_Transform);
+	m_PackedData->m_Transform = transform;
+	updatePositionRotationScaleFromTransform(m_PackedData->m_Transform);
 }
 
 void TransformComponent::setBounds(const BoundingBox& bounds)
 {
-	m_TransformBuffer.m_BoundingBox = bounds;
+	m_PackedData->m_BoundingBox = bounds;
 }
 
 void TransformComponent::setRotationPosition(const Matrix& transform)
 {
-	m_TransformBuffer.m_Transform = Matrix::CreateScale(m_TransformBuffer.m_Scale) * transform;
-	updatePositionRotationScaleFromTransform(m_TransformBuffer.m_Transform);
+	m_PackedData->m_Transform = Matrix::CreateScale(m_PackedData->m_Scale) * transform;
+	updatePositionRotationScaleFromTransform(m_PackedData->m_Transform);
 }
 
 void TransformComponent::addTransform(const Matrix& applyTransform)
@@ -129,7 +218,7 @@ void TransformComponent::addTransform(const Matrix& applyTransform)
 
 void TransformComponent::addRotation(const Quaternion& applyTransform)
 {
-	m_TransformBuffer.m_Rotation = Quaternion::Concatenate(applyTransform, m_TransformBuffer.m_Rotation);
+	m_PackedData->m_Rotation = Quaternion::Concatenate(applyTransform, m_PackedData->m_Rotation);
 	updateTransformFromPositionRotationScale();
 }
 
@@ -137,25 +226,25 @@ JSON::json TransformComponent::getJSON() const
 {
 	JSON::json j;
 
-	j["position"]["x"] = m_TransformBuffer.m_Position.x;
-	j["position"]["y"] = m_TransformBuffer.m_Position.y;
-	j["position"]["z"] = m_TransformBuffer.m_Position.z;
+	j["position"]["x"] = m_PackedData->m_Position.x;
+	j["position"]["y"] = m_PackedData->m_Position.y;
+	j["position"]["z"] = m_PackedData->m_Position.z;
 
-	j["rotation"]["x"] = m_TransformBuffer.m_Rotation.x;
-	j["rotation"]["y"] = m_TransformBuffer.m_Rotation.y;
-	j["rotation"]["z"] = m_TransformBuffer.m_Rotation.z;
-	j["rotation"]["w"] = m_TransformBuffer.m_Rotation.w;
+	j["rotation"]["x"] = m_PackedData->m_Rotation.x;
+	j["rotation"]["y"] = m_PackedData->m_Rotation.y;
+	j["rotation"]["z"] = m_PackedData->m_Rotation.z;
+	j["rotation"]["w"] = m_PackedData->m_Rotation.w;
 
-	j["scale"]["x"] = m_TransformBuffer.m_Scale.x;
-	j["scale"]["y"] = m_TransformBuffer.m_Scale.y;
-	j["scale"]["z"] = m_TransformBuffer.m_Scale.z;
+	j["scale"]["x"] = m_PackedData->m_Scale.x;
+	j["scale"]["y"] = m_PackedData->m_Scale.y;
+	j["scale"]["z"] = m_PackedData->m_Scale.z;
 
-	j["boundingBox"]["center"]["x"] = m_TransformBuffer.m_BoundingBox.Center.x;
-	j["boundingBox"]["center"]["y"] = m_TransformBuffer.m_BoundingBox.Center.y;
-	j["boundingBox"]["center"]["z"] = m_TransformBuffer.m_BoundingBox.Center.z;
-	j["boundingBox"]["extents"]["x"] = m_TransformBuffer.m_BoundingBox.Extents.x;
-	j["boundingBox"]["extents"]["y"] = m_TransformBuffer.m_BoundingBox.Extents.y;
-	j["boundingBox"]["extents"]["z"] = m_TransformBuffer.m_BoundingBox.Extents.z;
+	j["boundingBox"]["center"]["x"] = m_PackedData->m_BoundingBox.Center.x;
+	j["boundingBox"]["center"]["y"] = m_PackedData->m_BoundingBox.Center.y;
+	j["boundingBox"]["center"]["z"] = m_PackedData->m_BoundingBox.Center.z;
+	j["boundingBox"]["extents"]["x"] = m_PackedData->m_BoundingBox.Extents.x;
+	j["boundingBox"]["extents"]["y"] = m_PackedData->m_BoundingBox.Extents.y;
+	j["boundingBox"]["extents"]["z"] = m_PackedData->m_BoundingBox.Extents.z;
 
 	return j;
 }
@@ -164,22 +253,22 @@ JSON::json TransformComponent::getJSON() const
 #include "imgui.h"
 void TransformComponent::draw()
 {
-	ImGui::DragFloat3("##Position", &m_TransformBuffer.m_Position.x, s_EditorDecimalSpeed);
+	ImGui::DragFloat3("##Position", &m_PackedData->m_Position.x, s_EditorDecimalSpeed);
 	ImGui::SameLine();
 	if (ImGui::Button("Position"))
 	{
-		m_TransformBuffer.m_Position = { 0.0f, 0.0f, 0.0f };
+		m_PackedData->m_Position = { 0.0f, 0.0f, 0.0f };
 	}
 
 	if (ImGui::DragFloat3("##Rotation", &m_EditorRotation.x, s_EditorDecimalSpeed))
 	{
-		m_TransformBuffer.m_Rotation = Quaternion::CreateFromYawPitchRoll(m_EditorRotation.x, m_EditorRotation.y, m_EditorRotation.z);
+		m_PackedData->m_Rotation = Quaternion::CreateFromYawPitchRoll(m_EditorRotation.x, m_EditorRotation.y, m_EditorRotation.z);
 	}
 	ImGui::SameLine();
 	if (ImGui::Button("Rotation"))
 	{
 		m_EditorRotation = { 0.0f, 0.0f, 0.0f };
-		m_TransformBuffer.m_Rotation = Quaternion::CreateFromYawPitchRoll(m_EditorRotation.x, m_EditorRotation.y, m_EditorRotation.z);
+		m_PackedData->m_Rotation = Quaternion::CreateFromYawPitchRoll(m_EditorRotation.x, m_EditorRotation.y, m_EditorRotation.z);
 	}
 
 	static bool lockedFirstFrame = false;
@@ -190,57 +279,57 @@ void TransformComponent::draw()
 		static float scaleRatioZX;
 		if (!lockedFirstFrame)
 		{
-			lockedScale = m_TransformBuffer.m_Scale;
+			lockedScale = m_PackedData->m_Scale;
 			scaleRatioYX = lockedScale.y / lockedScale.x;
 			scaleRatioZX = lockedScale.z / lockedScale.x;
 			lockedFirstFrame = true;
 		}
 
-		if (lockedScale.x - m_TransformBuffer.m_Scale.x)
+		if (lockedScale.x - m_PackedData->m_Scale.x)
 		{
 			lockedScale.y = lockedScale.x * scaleRatioYX;
 			lockedScale.z = lockedScale.x * scaleRatioZX;
 		}
-		else if (lockedScale.y - m_TransformBuffer.m_Scale.y)
+		else if (lockedScale.y - m_PackedData->m_Scale.y)
 		{
 			lockedScale.x = lockedScale.y / scaleRatioYX;
 			lockedScale.z = lockedScale.y * scaleRatioZX / scaleRatioYX;
 		}
-		else if (lockedScale.z - m_TransformBuffer.m_Scale.z)
+		else if (lockedScale.z - m_PackedData->m_Scale.z)
 		{
 			lockedScale.x = lockedScale.z / scaleRatioZX;
 			lockedScale.y = lockedScale.z * scaleRatioYX / scaleRatioZX;
 		}
 
-		m_TransformBuffer.m_Scale = { lockedScale.x, lockedScale.y, lockedScale.z };
+		m_PackedData->m_Scale = { lockedScale.x, lockedScale.y, lockedScale.z };
 		ImGui::DragFloat3("##Scale", &lockedScale.x, s_EditorDecimalSpeed, 0.0f, 0.0f);
 	}
 	else
 	{
 		lockedFirstFrame = false;
-		ImGui::DragFloat3("##Scale", &m_TransformBuffer.m_Scale.x, s_EditorDecimalSpeed, 0.0f, 0.0f);
+		ImGui::DragFloat3("##Scale", &m_PackedData->m_Scale.x, s_EditorDecimalSpeed, 0.0f, 0.0f);
 	}
 	
 	ImGui::SameLine();
 	if (ImGui::Button("Scale"))
 	{
-		m_TransformBuffer.m_Scale = { 1.0f, 1.0f, 1.0f };
+		m_PackedData->m_Scale = { 1.0f, 1.0f, 1.0f };
 	}
 
 	ImGui::Checkbox("Lock Scale", &m_LockScale);
 
-	ImGui::DragFloat3("##Center", &m_TransformBuffer.m_BoundingBox.Center.x, s_EditorDecimalSpeed);
+	ImGui::DragFloat3("##Center", &m_PackedData->m_BoundingBox.Center.x, s_EditorDecimalSpeed);
 	ImGui::SameLine();
 	if (ImGui::Button("Center"))
 	{
-		m_TransformBuffer.m_BoundingBox.Center = { 0.0f, 0.0f, 0.0f };
+		m_PackedData->m_BoundingBox.Center = { 0.0f, 0.0f, 0.0f };
 	}
 
-	ImGui::DragFloat3("##Extents", &m_TransformBuffer.m_BoundingBox.Extents.x, s_EditorDecimalSpeed);
+	ImGui::DragFloat3("##Extents", &m_PackedData->m_BoundingBox.Extents.x, s_EditorDecimalSpeed);
 	ImGui::SameLine();
 	if (ImGui::Button("Extents"))
 	{
-		m_TransformBuffer.m_BoundingBox.Extents = { 0.5f, 0.5f, 0.5f };
+		m_PackedData->m_BoundingBox.Extents = { 0.5f, 0.5f, 0.5f };
 	}
 
 	updateTransformFromPositionRotationScale();
@@ -2,6 +2,7 @@
 
 #include "common/common.h"
 #include "component.h"
+#include "packed_storage.h"
 
 class TransformComponent : public Component
 {
@@ -16,6 +17,7 @@ private:
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
+	/// Local transform data, packed together with that of all other transforms.
 	struct TransformBuffer
 	{
 		Vector3 m_Position;
@@ -23,17 +25,39 @@ private:
 		Vector3 m_Scale;
 		BoundingBox m_BoundingBox;
 
+		/// Composed from position, rotation and scale by TransformHierarchy. Stale while m_IsLocalDirty is set.
 		Matrix m_Transform;
+		/// Set when position, rotation or scale change and the local transform matrix is yet to be composed from them.
+		bool m_IsLocalDirty;
 	};
-	TransformBuffer m_TransformBuffer;
+	/// Local transform data of every transform, so that TransformHierarchy composes them by walking packed arrays.
+	static PackedStorage<TransformBuffer, TransformComponent> s_PackedTransforms;
+	/// Entry of this transform in s_PackedTransforms. Kept up to date by the storage.
+	TransformBuffer* m_PackedData;
+	unsigned int m_PackedIndex;
+	friend class PackedStorage<TransformBuffer, TransformComponent>;
 	
 	Matrix m_ParentAbsoluteTransform;
+	/// Cached world transforms. Only TransformHierarchy refreshes them, on the main thread, so that any number of threads can read them.
+	/// Getters compute the transforms without caching them while the caches are stale.
+	Matrix m_AbsoluteTransform;
+	Matrix m_RotationPosition;
+	bool m_IsAbsoluteStale = true;
+	/// Incremented every time the world transform changes.
+	unsigned int m_Version = 0;
 	bool m_LockScale = false;
+	/// Set when the local transform changes. Cleared when TransformHierarchy updates the world transforms.
+	bool m_IsDirty = true;
 
-	const TransformBuffer* getTransformBuffer() const { return &m_TransformBuffer; };
+	const TransformBuffer* getTransformBuffer() const { return m_PackedData; };
 
 	void updateTransformFromPositionRotationScale();
 	void updatePositionRotationScaleFromTransform(Matrix& transform);
+	void markDirty();
+	/// Fill the local and world transform caches. Called by TransformHierarchy.
+	void refreshCaches();
+	/// Called by TransformHierarchy with the new world transform of the parent.
+	void setParentAbsoluteTransform(const Matrix& parentAbsoluteTransform);
 
 	TransformComponent(const Vector3& position, const Vector4& rotation, const Vector3& scale, const BoundingBox& bounds);
 	TransformComponent(TransformComponent&) = delete;
@@ -41,6 +65,7 @@ private:
 	friend class ModelComponent;
 	friend class RenderSystem;
 	friend class EntityFactory;
+	friend class TransformHierarchy;
 
 #ifdef ROOTEX_EDITOR
 	static inline const float s_EditorDecimalSpeed = 0.01f;
@@ -52,8 +77,9 @@ public:
 	static void RegisterAPI(sol::table& rootex);
 
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::TransformComponent;
+	static const bool s_IsCloneable = true;
 
-	virtual ~TransformComponent() = default;
+	virtual ~TransformComponent();
 
 	void setPosition(const Vector3& position);
 	void setRotation(const float& yaw, const float& pitch, const float& roll);
@@ -66,17 +92,21 @@ public:
 	void addTransform(const Matrix& applyTransform);
 	void addRotation(const Quaternion& applyTransform);
 
-	Vector3 getPosition() const { return m_TransformBuffer.m_Position; }
-	BoundingBox getBounds() const { return m_TransformBuffer.m_BoundingBox; }
-	const Quaternion& getRotation() const { return m_TransformBuffer.m_Rotation; }
-	const Vector3& getScale() const { return m_TransformBuffer.m_Scale; }
-	const Matrix& getLocalTransform() const { return m_TransformBuffer.m_Transform; }
-	Matrix getRotationPosition() const { return Matrix::CreateFromQuaternion(m_TransformBuffer.m_Rotation) * Matrix::CreateTranslation(m_TransformBuffer.m_Position) * m_ParentAbsoluteTransform; }
-	Matrix getAbsoluteTransform() const { return m_TransformBuffer.m_Transform * m_ParentAbsoluteTransform; }
+	Vector3 getPosition() const { return m_PackedData->m_Position; }
+	BoundingBox getBounds() const { return m_PackedData->m_BoundingBox; }
+	const Quaternion& getRotation() const { return m_PackedData->m_Rotation; }
+	const Vector3& getScale() const { return m_PackedData->m_Scale; }
+	Matrix getLocalTransform() const;
+	/// World transform without the scale of this transform.
+	Matrix getRotationPosition() const;
+	Matrix getAbsoluteTransform() const;
 	Matrix getParentAbsoluteTransform() const { return m_ParentAbsoluteTransform; }
+	/// Changes whenever the world transform changes. Compare with a stored version to skip work for unmoved transforms.
+	unsigned int getVersion() const { return m_Version; }
 	ComponentID getComponentID() const override { return s_ID; }
 	virtual String getName() const override { return "TransformComponent"; }
 	virtual JSON::json getJSON() const override;
+	virtual Component* clone() const override;
 
 #ifdef ROOTEX_EDITOR
 	void draw() override;
@@ -0,0 +1,99 @@
+#include "transform_hierarchy.h"
+
+#include "hierarchy_component.h"
+#include "transform_component.h"
+
+Vector<TransformComponent*> TransformHierarchy::s_Transforms;
+Vector<int> TransformHierarchy::s_Parents;
+Vector<bool> TransformHierarchy::s_IsWorldDirty;
+TransformArrays TransformHierarchy::s_ComposeInputs;
+Vector<TransformComponent*> TransformHierarchy::s_ComposeTransforms;
+Vector<Matrix> TransformHierarchy::s_ComposeResults;
+Atomic<bool> TransformHierarchy::s_IsStructureDirty(true);
+Atomic<bool> TransformHierarchy::s_IsAnyTransformDirty(true);
+
+void TransformHierarchy::Rebuild(HierarchyComponent* root)
+{
+	s_Transforms.clear();
+	s_Parents.clear();
+
+	// Hierarchy nodes paired with the index of their nearest ancestor having a transform
+	Vector<Tuple<HierarchyComponent*, int>> stack;
+	stack.push_back({ root, -1 });
+	while (!stack.empty())
+	{
+		auto [node, parent] = stack.back();
+		stack.pop_back();
+
+		if (TransformComponent* transform = node->getOwner()->getComponentPointer<TransformComponent>())
+		{
+			s_Transforms.push_back(transform);
+			s_Parents.push_back(parent);
+			transform->m_IsDirty = true;
+			parent = s_Transforms.size() - 1;
+		}
+
+		for (HierarchyComponent* child = node->getLastChild(); child; child = child->getPreviousSibling())
+		{
+			stack.push_back({ child, parent });
+		}
+	}
+
+	s_IsWorldDirty.resize(s_Transforms.size());
+}
+
+void TransformHierarchy::ComposeLocalTransforms()
+{
+	s_ComposeInputs.clear();
+	s_ComposeTransforms.clear();
+	TransformComponent::s_PackedTransforms.eachChunk([](TransformComponent::TransformBuffer* buffers, TransformComponent* const* owners, unsigned int count) {
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (buffers[i].m_IsLocalDirty)
+			{
+				s_ComposeInputs.push(buffers[i].m_Position, buffers[i].m_Rotation, buffers[i].m_Scale);
+				s_ComposeTransforms.push_back(owners[i]);
+			}
+		}
+	});
+
+	s_ComposeResults.resize(s_ComposeTransforms.size());
+	TransformBatch::Compose(s_ComposeInputs, s_ComposeResults.data());
+
+	for (size_t i = 0; i < s_ComposeTransforms.size(); i++)
+	{
+		s_ComposeTransforms[i]->m_PackedData->m_Transform = s_ComposeResults[i];
+		s_ComposeTransforms[i]->m_PackedData->m_IsLocalDirty = false;
+	}
+}
+
+void TransformHierarchy::Update(HierarchyComponent* root)
+{
+	if (s_IsStructureDirty.exchange(false))
+	{
+		Rebuild(root);
+		s_IsAnyTransformDirty = true;
+	}
+	if (!s_IsAnyTransformDirty.exchange(false))
+	{
+		return;
+	}
+
+	ComposeLocalTransforms();
+
+	for (size_t i = 0; i < s_Transforms.size(); i++)
+	{
+		TransformComponent* transform = s_Transforms[i];
+		int parent = s_Parents[i];
+
+		bool isDirty = transform->m_IsDirty || (parent != -1 && s_IsWorldDirty[parent]);
+		s_IsWorldDirty[i] = isDirty;
+		if (isDirty)
+		{
+			transform->setParentAbsoluteTransform(parent == -1 ? Matrix::Identity : s_Transforms[parent]->m_AbsoluteTransform);
+			// Readers never fill the caches themselves, so that they can read them from any thread
+			transform->refreshCaches();
+			transform->m_IsDirty = false;
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/common.h"
+#include "transform_batch.h"
+
+class TransformComponent;
+class HierarchyComponent;
+
+/// Transforms of the hierarchy flattened into arrays in depth first order, so that parents always come before their children.
+/// World transforms are recomputed only for the transforms marked dirty and their descendants, and cached in each TransformComponent.
+class TransformHierarchy
+{
+	static Vector<TransformComponent*> s_Transforms;
+	/// Index of the parent transform of each transform. -1 for the topmost transform.
+	static Vector<int> s_Parents;
+	/// Whether the world transform of each transform changed in the last update.
+	static Vector<bool> s_IsWorldDirty;
+
+	/// Scratch space for composing local transforms in a batch.
+	static TransformArrays s_ComposeInputs;
+	static Vector<TransformComponent*> s_ComposeTransforms;
+	static Vector<Matrix> s_ComposeResults;
+
+	static Atomic<bool> s_IsStructureDirty;
+	static Atomic<bool> s_IsAnyTransformDirty;
+
+	static void Rebuild(HierarchyComponent* root);
+	/// Compose the local transforms whose position, rotation or scale changed, all at once.
+	/// Finds them by walking the packed transform data, so transforms that are not yet in the hierarchy are composed too.
+	static void ComposeLocalTransforms();
+
+public:
+	/// Call when the hierarchy is edited or a transform is destroyed.
+	static void MarkStructureDirty() { s_IsStructureDirty = true; }
+	/// Call when a local transform changes.
+	static void MarkTransformDirty() { s_IsAnyTransformDirty = true; }
+
+	/// Flatten the hierarchy again if it was edited and recompute world transforms of dirty subtrees.
+	/// Returns immediately if nothing changed since the last update.
+	static void Update(HierarchyComponent* root);
+};
@@ -7,6 +7,11 @@ Component* TriggerComponent::Create(const JSON::json& componentData)
 	return new TriggerComponent(componentData["targetEntityID"]);
 }
 
+Component* TriggerComponent::clone() const
+{
+	return new TriggerComponent(m_TargetEntityID);
+}
+
 Component* TriggerComponent::CreateDefault()
 {
 	return new TriggerComponent(INVALID_ID);
@@ -102,9 +107,9 @@ void TriggerComponent::draw()
 	{
 		for (auto& entity : EntityFactory::GetSingleton()->getEntities())
 		{
-			if (ImGui::Selectable(entity.second->getFullName().c_str()))
+			if (ImGui::Selectable(entity->getFullName().c_str()))
 			{
-				setTarget(entity.second);
+				setTarget(entity);
 			}
 		}
 
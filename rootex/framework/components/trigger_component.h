@@ -19,6 +19,7 @@ class TriggerComponent : public Component
 
 public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::TriggerComponent;
+	static const bool s_IsCloneable = true;
 
 	virtual bool setupEntities() override;
 
@@ -28,6 +29,7 @@ public:
 	virtual String getName() const override { return "TriggerComponent"; }
 	ComponentID getComponentID() const { return s_ID; }
 	virtual JSON::json getJSON() const override;
+	virtual Component* clone() const override;
 
 #ifdef ROOTEX_EDITOR
 	virtual void draw();
@@ -73,6 +73,7 @@ CameraComponent::CameraComponent(const Vector2& aspectRatio, float fov, float ne
     , m_Near(nearPlane)
     , m_Far(farPlane)
     , m_TransformComponent(nullptr)
+    , m_ViewTransformVersion(0)
     , m_PostProcessingDetails(postProcesing)
 {
 }
@@ -89,6 +90,7 @@ void CameraComponent::refreshViewMatrix()
 	    absoluteTransform.Translation(),
 	    absoluteTransform.Translation() + absoluteTransform.Forward(),
 	    absoluteTransform.Up());
+	m_ViewTransformVersion = m_TransformComponent->getVersion();
 }
 
 void CameraComponent::onRemove()
@@ -119,7 +121,10 @@ bool CameraComponent::setup()
 
 const Matrix& CameraComponent::getViewMatrix()
 {
-	refreshViewMatrix();
+	if (m_ViewTransformVersion != m_TransformComponent->getVersion())
+	{
+		refreshViewMatrix();
+	}
 	return m_ViewMatrix;
 }
 
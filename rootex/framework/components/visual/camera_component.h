@@ -40,6 +40,8 @@ class CameraComponent : public Component
 	Matrix m_ViewMatrix;
 	Matrix m_ProjectionMatrix;
 	TransformComponent* m_TransformComponent;
+	/// Version of the transform that m_ViewMatrix was computed from.
+	unsigned int m_ViewTransformVersion;
 
 	CameraComponent(const Vector2& aspectRatio, float fov, float nearPlane, float farPlane, const PostProcessingDetails& postProcesing);
 	CameraComponent(CameraComponent&) = delete;
@@ -1,5 +1,7 @@
 #include "point_light_component.h"
 
+PackedStorage<PointLight, PointLightComponent> PointLightComponent::s_PackedPointLights;
+
 Component* PointLightComponent::Create(const JSON::json& componentData)
 {
 	PointLightComponent* pointLightComponent = new PointLightComponent(
@@ -16,6 +18,18 @@ Component* PointLightComponent::Create(const JSON::json& componentData)
 	return pointLightComponent;
 }
 
+Component* PointLightComponent::clone() const
+{
+	return new PointLightComponent(
+	    m_PackedData->attConst,
+	    m_PackedData->attLin,
+	    m_PackedData->attQuad,
+	    m_PackedData->range,
+	    m_PackedData->diffuseIntensity,
+	    m_PackedData->diffuseColor,
+	    m_PackedData->ambientColor);
+}
+
 Component* PointLightComponent::CreateDefault()
 {
 	PointLightComponent* pointLightComponent = new PointLightComponent(
@@ -31,36 +45,45 @@ Component* PointLightComponent::CreateDefault()
 }
 
 PointLightComponent::PointLightComponent(const float constAtt, const float linAtt, const float quadAtt,
-    const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor)
+    const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor,
+    PackedStorage<PointLight, PointLightComponent>& storage)
+    : m_Storage(&storage)
+{
+	PointLight pointLight;
+	pointLight.ambientColor = ambientColor;
+	pointLight.attConst = constAtt;
+	pointLight.attLin = linAtt;
+	pointLight.attQuad = quadAtt;
+	pointLight.diffuseColor = diffuseColor;
+	pointLight.diffuseIntensity = diffuseIntensity;
+	pointLight.range = range;
+	m_Storage->add(this, pointLight);
+}
+
+PointLightComponent::~PointLightComponent()
 {
-	m_PointLight.ambientColor = ambientColor;
-	m_PointLight.attConst = constAtt;
-	m_PointLight.attLin = linAtt;
-	m_PointLight.attQuad = quadAtt;
-	m_PointLight.diffuseColor = diffuseColor;
-	m_PointLight.diffuseIntensity = diffuseIntensity;
-	m_PointLight.range = range;
+	m_Storage->remove(this);
 }
 
 JSON::json PointLightComponent::getJSON() const
 {
 	JSON::json j;
 
-	j["attConst"] = m_PointLight.attConst;
-	j["attLin"] = m_PointLight.attLin;
-	j["attQuad"] = m_PointLight.attQuad;
-	j["range"] = m_PointLight.range;
-	j["diffuseIntensity"] = m_PointLight.diffuseIntensity;
+	j["attConst"] = m_PackedData->attConst;
+	j["attLin"] = m_PackedData->attLin;
+	j["attQuad"] = m_PackedData->attQuad;
+	j["range"] = m_PackedData->range;
+	j["diffuseIntensity"] = m_PackedData->diffuseIntensity;
 
-	j["diffuseColor"]["r"] = m_PointLight.diffuseColor.x;
-	j["diffuseColor"]["g"] = m_PointLight.diffuseColor.y;
-	j["diffuseColor"]["b"] = m_PointLight.diffuseColor.z;
-	j["diffuseColor"]["a"] = m_PointLight.diffuseColor.w;
+	j["diffuseColor"]["r"] = m_PackedData->diffuseColor.x;
+	j["diffuseColor"]["g"] = m_PackedData->diffuseColor.y;
+	j["diffuseColor"]["b"] = m_PackedData->diffuseColor.z;
+	j["diffuseColor"]["a"] = m_PackedData->diffuseColor.w;
 
-	j["ambientColor"]["r"] = m_PointLight.ambientColor.x;
-	j["ambientColor"]["g"] = m_PointLight.ambientColor.y;
-	j["ambientColor"]["b"] = m_PointLight.ambientColor.z;
-	j["ambientColor"]["a"] = m_PointLight.ambientColor.w;
+	j["ambientColor"]["r"] = m_PackedData->ambientColor.x;
+	j["ambientColor"]["g"] = m_PackedData->ambientColor.y;
+	j["ambientColor"]["b"] = m_PackedData->ambientColor.z;
+	j["ambientColor"]["a"] = m_PackedData->ambientColor.w;
 
 	return j;
 }
@@ -69,12 +92,12 @@ JSON::json PointLightComponent::getJSON() const
 #include"imgui.h"
 void PointLightComponent::draw()
 {
-	ImGui::DragFloat("Diffuse Intensity##Point", &m_PointLight.diffuseIntensity, 0.1f);
-	ImGui::ColorEdit4("Diffuse Color##Point", &m_PointLight.diffuseColor.x);
-	ImGui::ColorEdit4("Ambient Color##Point", &m_PointLight.ambientColor.x);
-	ImGui::DragFloat("Constant Attenuation##Point", &m_PointLight.attConst, 0.01f);
-	ImGui::DragFloat("Linear Attenuation##Point", &m_PointLight.attLin, 0.01f);
-	ImGui::DragFloat("Quadratic Attenuation##Point", &m_PointLight.attQuad, 0.01f);
-	ImGui::DragFloat("Range##Point", &m_PointLight.range, 0.1f);
+	ImGui::DragFloat("Diffuse Intensity##Point", &m_PackedData->diffuseIntensity, 0.1f);
+	ImGui::ColorEdit4("Diffuse Color##Point", &m_PackedData->diffuseColor.x);
+	ImGui::ColorEdit4("Ambient Color##Point", &m_PackedData->ambientColor.x);
+	ImGui::DragFloat("Constant Attenuation##Point", &m_PackedData->attConst, 0.01f);
+	ImGui::DragFloat("Linear Attenuation##Point", &m_PackedData->attLin, 0.01f);
+	ImGui::DragFloat("Quadratic Attenuation##Point", &m_PackedData->attQuad, 0.01f);
+	ImGui::DragFloat("Range##Point", &m_PackedData->range, 0.1f);
 }
 #endif // ROOTEX_EDITOR
@@ -2,6 +2,7 @@
 
 #include "component.h"
 #include "common/common.h"
+#include "packed_storage.h"
 
 #include "core/renderer/point_light.h"
 
@@ -11,24 +12,38 @@ class PointLightComponent : public Component
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
-	PointLight m_PointLight;
+	/// Settings of every dynamic point light, so that LightSystem gathers them by walking packed arrays.
+	static PackedStorage<PointLight, PointLightComponent> s_PackedPointLights;
+
+	/// Entry of this light in m_Storage. Kept up to date by the storage.
+	PointLight* m_PackedData;
+	unsigned int m_PackedIndex;
+	PackedStorage<PointLight, PointLightComponent>* m_Storage;
+	friend class PackedStorage<PointLight, PointLightComponent>;
 
 protected:
+	/// Light settings are kept in storage, which lets static point lights keep theirs apart from the dynamic ones.
 	PointLightComponent::PointLightComponent(const float constAtt, const float linAtt, const float quadAtt,
-	    const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor);
+	    const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor,
+	    PackedStorage<PointLight, PointLightComponent>& storage = s_PackedPointLights);
 	PointLightComponent(PointLightComponent&) = delete;
-	~PointLightComponent() = default;
+	~PointLightComponent();
 
 	friend class EntityFactory;
 
 public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::PointLightComponent;
+	static const bool s_IsCloneable = true;
+
+	/// Settings of all dynamic point lights, with the components owning them. Excludes static point lights.
+	static PackedStorage<PointLight, PointLightComponent>& GetPackedPointLights() { return s_PackedPointLights; }
 
-	const PointLight& getPointLight() const { return m_PointLight; }
+	const PointLight& getPointLight() const { return *m_PackedData; }
 
 	virtual String getName() const override { return "PointLightComponent"; }
 	ComponentID getComponentID() const override { return s_ID; }
 	virtual JSON::json getJSON() const override;
+	virtual Component* clone() const override;
 
 #ifdef ROOTEX_EDITOR
 	void draw() override;
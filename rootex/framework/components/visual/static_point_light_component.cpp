@@ -1,5 +1,7 @@
 #include "static_point_light_component.h"
 
+PackedStorage<PointLight, PointLightComponent> StaticPointLightComponent::s_PackedStaticPointLights;
+
 Component* StaticPointLightComponent::Create(const JSON::json& componentData)
 {
 	StaticPointLightComponent* staticPointLightComponent = new StaticPointLightComponent(
@@ -16,6 +18,19 @@ Component* StaticPointLightComponent::Create(const JSON::json& componentData)
 	return staticPointLightComponent;
 }
 
+Component* StaticPointLightComponent::clone() const
+{
+	const PointLight& pointLight = getPointLight();
+	return new StaticPointLightComponent(
+	    pointLight.attConst,
+	    pointLight.attLin,
+	    pointLight.attQuad,
+	    pointLight.range,
+	    pointLight.diffuseIntensity,
+	    pointLight.diffuseColor,
+	    pointLight.ambientColor);
+}
+
 Component* StaticPointLightComponent::CreateDefault()
 {
 	StaticPointLightComponent* staticPointLightComponent = new StaticPointLightComponent(
@@ -31,7 +46,7 @@ Component* StaticPointLightComponent::CreateDefault()
 }
 
 StaticPointLightComponent::StaticPointLightComponent(const float constAtt, const float linAtt, const float quadAtt, const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor)
-    : PointLightComponent(constAtt, linAtt, quadAtt, range, diffuseIntensity, diffuseColor, ambientColor)
+    : PointLightComponent(constAtt, linAtt, quadAtt, range, diffuseIntensity, diffuseColor, ambientColor, s_PackedStaticPointLights)
 {
 }
 
@@ -13,6 +13,9 @@ class StaticPointLightComponent : public PointLightComponent
 	static Component* Create(const JSON::json& componentData);
 	static Component* CreateDefault();
 
+	/// Kept apart from the dynamic point lights, which are gathered every frame.
+	static PackedStorage<PointLight, PointLightComponent> s_PackedStaticPointLights;
+
 	StaticPointLightComponent::StaticPointLightComponent(const float constAtt, const float linAtt, const float quadAtt,
 	    const float range, const float diffuseIntensity, const Color& diffuseColor, const Color& ambientColor);
 	StaticPointLightComponent(StaticPointLightComponent&) = delete;
@@ -24,6 +27,7 @@ public:
 	static const ComponentID s_ID = (ComponentID)ComponentIDs::StaticPointLightComponent;
 
 	virtual String getName() const override { return "StaticPointLightComponent"; }
+	virtual Component* clone() const override;
 	ComponentID getComponentID() const override { return s_ID; }
 	virtual JSON::json getJSON() const override;
 
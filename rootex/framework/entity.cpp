@@ -4,6 +4,7 @@
 #include "framework/component.h"
 #include "framework/components/hierarchy_component.h"
 #include "framework/system.h"
+#include "framework/view.h"
 
 void Entity::RegisterAPI(sol::table& rootex)
 {
@@ -28,7 +29,11 @@ Entity::~Entity()
 
 void Entity::addComponent(const Ref<Component>& component)
 {
-	m_Components.insert(std::make_pair(component->getComponentID(), component));
+	if (m_Components.insert(std::make_pair(component->getComponentID(), component)).second)
+	{
+		m_ComponentSlots[component->getComponentID()] = component.get();
+		ViewBase::ComponentAdded(this, component->getComponentID());
+	}
 }
 
 Entity::Entity(EntityID id, const String& name, const HashMap<ComponentID, Ref<Component>>& components)
@@ -37,6 +42,18 @@ Entity::Entity(EntityID id, const String& name, const HashMap<ComponentID, Ref<C
     , m_Components(components)
     , m_IsEditorOnly(false)
 {
+	for (auto& componentSlot : m_ComponentSlots)
+	{
+		componentSlot = nullptr;
+	}
+	for (auto& [componentID, component] : m_Components)
+	{
+		m_ComponentSlots[componentID] = component.get();
+	}
+	for (auto& [componentID, component] : m_Components)
+	{
+		ViewBase::ComponentAdded(this, componentID);
+	}
 }
 
 JSON::json Entity::getJSON() const
@@ -78,8 +95,10 @@ void Entity::destroy()
 	for (auto& component : m_Components)
 	{
 		component.second->onRemove();
+		ViewBase::ComponentRemoved(this, component.first);
 		System::DeregisterComponent(component.second.get());
 		component.second.reset();
+		m_ComponentSlots[component.first] = nullptr;
 	}
 	m_Components.clear();
 }
@@ -87,7 +106,9 @@ void Entity::destroy()
 void Entity::removeComponent(Ref<Component> component)
 {
 	component->onRemove();
+	ViewBase::ComponentRemoved(this, component->getComponentID());
 	m_Components.erase(component->getComponentID());
+	m_ComponentSlots[component->getComponentID()] = nullptr;
 	System::DeregisterComponent(component.get());
 }
 
@@ -108,7 +129,7 @@ String Entity::getFullName() const
 
 bool Entity::hasComponent(ComponentID componentID)
 {
-	return m_Components.find(componentID) != m_Components.end();
+	return componentID < MAX_COMPONENT_IDS && m_ComponentSlots[componentID];
 }
 
 void Entity::setName(const String& name)
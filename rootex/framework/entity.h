@@ -3,20 +3,57 @@
 #include "common/common.h"
 #include "script/interpreter.h"
 #include "event.h"
+#include "components/component_ids.h"
+#include "pool_allocator.h"
 
 class Component;
 
 typedef unsigned int ComponentID;
 typedef int EntityID;
 
+/// Bits of an EntityHandle used to store the EntityID. The rest store the generation.
+#define ENTITY_HANDLE_ID_BITS 22
+#define ENTITY_HANDLE_ID_MASK ((1u << ENTITY_HANDLE_ID_BITS) - 1)
+#define ENTITY_HANDLE_GENERATION_MASK ((1u << (32 - ENTITY_HANDLE_ID_BITS)) - 1)
+/// Largest EntityID that survives the sign extension in EntityHandle::getID().
+#define ENTITY_HANDLE_MAX_ID ((EntityID)(ENTITY_HANDLE_ID_MASK >> 1))
+
+/// 32 bit reference to an entity that can be checked for staleness in constant time.
+/// EntityIDs are reused after their entity is deleted, the generation tells apart the entities that held the same EntityID.
+class EntityHandle
+{
+	unsigned int m_Value;
+
+public:
+	EntityHandle()
+	    : m_Value(0)
+	{
+	}
+	EntityHandle(EntityID id, unsigned int generation)
+	    : m_Value(((unsigned int)id & ENTITY_HANDLE_ID_MASK) | (generation << ENTITY_HANDLE_ID_BITS))
+	{
+	}
+
+	/// Sign extends the stored ID so that the negative editor IDs survive.
+	EntityID getID() const { return (EntityID)(m_Value << (32 - ENTITY_HANDLE_ID_BITS)) >> (32 - ENTITY_HANDLE_ID_BITS); }
+	unsigned int getGeneration() const { return m_Value >> ENTITY_HANDLE_ID_BITS; }
+	unsigned int getValue() const { return m_Value; }
+
+	bool operator==(const EntityHandle& other) const { return m_Value == other.m_Value; }
+	bool operator!=(const EntityHandle& other) const { return m_Value != other.m_Value; }
+};
+
 /// A collection of ECS style components that define an ECS style entity.
 /// Use EntityFactory to create Entity objects.
 class Entity
 {
 protected:
 	EntityID m_ID;
+	EntityHandle m_Handle;
 	String m_Name;
 	HashMap<ComponentID, Ref<Component>> m_Components;
+	/// Same components as m_Components, indexed directly by ComponentID.
+	Component* m_ComponentSlots[MAX_COMPONENT_IDS];
 	bool m_IsEditorOnly;
 	
 	Entity(EntityID id, const String& name, const HashMap<ComponentID, Ref<Component>>& components = {});
@@ -34,6 +71,8 @@ protected:
 public:
 	static void RegisterAPI(sol::table& rootex);
 
+	POOL_ALLOCATED_CLASS
+
 	virtual ~Entity();
 
 	void removeComponent(Ref<Component> component);
@@ -43,6 +82,8 @@ public:
 	bool hasComponent(ComponentID componentID);
 	
 	EntityID getID() const;
+	/// Handle given by EntityFactory. Stays valid till the entity is deleted.
+	EntityHandle getHandle() const { return m_Handle; }
 	const String& getName() const;
 	/// Full name consists of entity name followed by the corresponding EntityID.
 	String getFullName() const;
@@ -53,6 +94,12 @@ public:
 	template <class ComponentType = Component>
 	Ref<ComponentType> getComponentFromID(ComponentID ID) const;
 
+	/// Constant time lookup. The pointer stays valid till the component is removed from this entity.
+	/// Components sharing a ComponentID, like GridModelComponent and ModelComponent, should be fetched by the type owning the ID.
+	/// Debug builds check the type of the component and return nullptr on a mismatch, release builds don't check.
+	template <class ComponentType = Component>
+	ComponentType* getComponentPointer() const;
+
 	JSON::json getJSON() const;
 	const HashMap<ComponentID, Ref<Component>>& getAllComponents() const;
 	bool isEditorOnly() const { return m_IsEditorOnly; }
@@ -86,3 +133,17 @@ inline Ref<ComponentType> Entity::getComponentFromID(ComponentID ID) const
 
 	return nullptr;
 }
+
+template <class ComponentType>
+inline ComponentType* Entity::getComponentPointer() const
+{
+	Component* component = m_ComponentSlots[ComponentType::s_ID];
+#ifdef _DEBUG
+	if (component && !dynamic_cast<ComponentType*>(component))
+	{
+		ERR("Component of entity " + getFullName() + " does not have the requested type, it shares its ComponentID with another type");
+		return nullptr;
+	}
+#endif // _DEBUG
+	return static_cast<ComponentType*>(component);
+}
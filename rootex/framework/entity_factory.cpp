@@ -32,8 +32,9 @@
 #include "components/visual/ui_component.h"
 #include "systems/hierarchy_system.h"
 
-#define REGISTER_COMPONENT(ComponentClass)                                                            \
-	m_ComponentCreators.push_back({ ComponentClass::s_ID, #ComponentClass, ComponentClass::Create }); \
+#define REGISTER_COMPONENT(ComponentClass)                                                                                          \
+	m_ComponentCreatorIndices[#ComponentClass] = m_ComponentCreators.size();                                                        \
+	m_ComponentCreators.push_back({ ComponentClass::s_ID, #ComponentClass, ComponentClass::Create, ComponentClass::s_IsCloneable }); \
 	m_DefaultComponentCreators.push_back({ ComponentClass::s_ID, #ComponentClass, ComponentClass::CreateDefault })
 
 EntityID EntityFactory::s_CurrentID = ROOT_ENTITY_ID;
@@ -55,6 +56,23 @@ EntityFactory* EntityFactory::GetSingleton()
 
 EntityID EntityFactory::getNextID()
 {
+	while (!m_FreeIDs.empty())
+	{
+		EntityID id = m_FreeIDs.back();
+		m_FreeIDs.pop_back();
+		// IDs loaded from files may have taken a free ID already and must not be given out even after their entity is deleted
+		EntitySlot* slot = findSlot(id);
+		if (!slot || (slot->m_EntityIndex == -1 && !slot->m_IsPersistentID))
+		{
+			return id;
+		}
+	}
+
+	if (s_CurrentID >= ENTITY_HANDLE_MAX_ID)
+	{
+		ERR("Ran out of entity IDs, " + std::to_string(ENTITY_HANDLE_MAX_ID) + " entity IDs are in use");
+		return INVALID_ID;
+	}
 	return ++s_CurrentID;
 }
 
@@ -63,6 +81,61 @@ EntityID EntityFactory::getNextEditorID()
 	return --s_CurrentEditorID;
 }
 
+EntityFactory::EntitySlot* EntityFactory::findSlot(EntityID entityID)
+{
+	if (entityID >= 0)
+	{
+		return entityID < m_Slots.size() ? &m_Slots[entityID] : nullptr;
+	}
+	return -entityID < m_EditorSlots.size() ? &m_EditorSlots[-entityID] : nullptr;
+}
+
+void EntityFactory::addEntity(const Ref<Entity>& entity, bool isPersistentID)
+{
+	EntityID id = entity->m_ID;
+	Vector<EntitySlot>& slots = id >= 0 ? m_Slots : m_EditorSlots;
+	unsigned int slotIndex = id >= 0 ? id : -id;
+	if (slotIndex >= slots.size())
+	{
+		slots.resize(slotIndex + 1);
+	}
+
+	EntitySlot& slot = slots[slotIndex];
+	if (slot.m_EntityIndex != -1)
+	{
+		WARN("Replacing entity with a duplicate ID: " + m_Entities[slot.m_EntityIndex]->getFullName());
+		m_Entities[slot.m_EntityIndex] = entity;
+	}
+	else
+	{
+		slot.m_EntityIndex = m_Entities.size();
+		m_Entities.push_back(entity);
+	}
+	slot.m_IsPersistentID = slot.m_IsPersistentID || isPersistentID;
+	entity->m_Handle = EntityHandle(id, slot.m_Generation);
+}
+
+void EntityFactory::removeEntity(Entity* entity)
+{
+	EntitySlot* slot = findSlot(entity->m_ID);
+	if (!slot || slot->m_EntityIndex == -1 || m_Entities[slot->m_EntityIndex].get() != entity)
+	{
+		return;
+	}
+
+	Ref<Entity>& last = m_Entities.back();
+	findSlot(last->m_ID)->m_EntityIndex = slot->m_EntityIndex;
+	m_Entities[slot->m_EntityIndex] = last;
+	m_Entities.pop_back();
+
+	slot->m_EntityIndex = -1;
+	slot->m_Generation = (slot->m_Generation + 1) & ENTITY_HANDLE_GENERATION_MASK;
+	if (entity->m_ID > ROOT_ENTITY_ID && !slot->m_IsPersistentID)
+	{
+		m_FreeIDs.push_back(entity->m_ID);
+	}
+}
+
 EntityFactory::EntityFactory()
 {
 	BIND_EVENT_MEMBER_FUNCTION("DeleteEntity", deleteEntityEvent);
@@ -94,56 +167,68 @@ EntityFactory::EntityFactory()
 	REGISTER_COMPONENT(UIComponent);
 }
 
-Ref<Component> EntityFactory::createComponent(const String& name, const JSON::json& componentData)
+int EntityFactory::getComponentCreatorIndex(const String& name) const
 {
-	auto& findIt = m_ComponentCreators.end();
-	for (auto& componentClass = m_ComponentCreators.begin(); componentClass != m_ComponentCreators.end(); componentClass++)
+	auto findIt = m_ComponentCreatorIndices.find(name);
+	if (findIt != m_ComponentCreatorIndices.end())
 	{
-		if (Extract(String, *componentClass) == name)
-		{
-			findIt = componentClass;
-		}
+		return findIt->second;
 	}
-	if (findIt != m_ComponentCreators.end())
-	{
-		ComponentCreator create = Extract(ComponentCreator, *findIt);
-		Ref<Component> component(create(componentData));
-
-		System::RegisterComponent(component.get());
+	return -1;
+}
 
-		return component;
-	}
-	else
+Ref<Component> EntityFactory::createComponent(const String& name, const JSON::json& componentData)
+{
+	int creatorIndex = getComponentCreatorIndex(name);
+	if (creatorIndex == -1)
 	{
 		ERR("Could not find component creator: " + name);
 		return nullptr;
 	}
+	return createComponent((unsigned int)creatorIndex, componentData);
 }
 
-Ref<Component> EntityFactory::createDefaultComponent(const String& name)
+Ref<Component> EntityFactory::createComponent(unsigned int creatorIndex, const JSON::json& componentData)
 {
-	auto& findIt = m_DefaultComponentCreators.end();
-	for (auto& componentClass = m_DefaultComponentCreators.begin(); componentClass != m_DefaultComponentCreators.end(); componentClass++)
+	if (creatorIndex >= m_ComponentCreators.size())
 	{
-		if (Extract(String, *componentClass) == name)
-		{
-			findIt = componentClass;
-		}
+		ERR("Could not find component creator: " + std::to_string(creatorIndex));
+		return nullptr;
 	}
-	if (findIt != m_DefaultComponentCreators.end())
-	{
-		ComponentDefaultCreator create = Extract(ComponentDefaultCreator, *findIt);
-		Ref<Component> component(create());
 
-		System::RegisterComponent(component.get());
+	ComponentCreator create = Extract(ComponentCreator, m_ComponentCreators[creatorIndex]);
+	Ref<Component> component = MakePooledRef(create(componentData));
 
-		return component;
-	}
-	else
+	System::RegisterComponent(component.get());
+
+	return component;
+}
+
+Ref<Component> EntityFactory::createDefaultComponent(const String& name)
+{
+	int creatorIndex = getComponentCreatorIndex(name);
+	if (creatorIndex == -1)
 	{
 		ERR("Could not find default component creator: " + name);
 		return nullptr;
 	}
+	return createDefaultComponent((unsigned int)creatorIndex);
+}
+
+Ref<Component> EntityFactory::createDefaultComponent(unsigned int creatorIndex)
+{
+	if (creatorIndex >= m_DefaultComponentCreators.size())
+	{
+		ERR("Could not find default component creator: " + std::to_string(creatorIndex));
+		return nullptr;
+	}
+
+	ComponentDefaultCreator create = Extract(ComponentDefaultCreator, m_DefaultComponentCreators[creatorIndex]);
+	Ref<Component> component = MakePooledRef(create());
+
+	System::RegisterComponent(component.get());
+
+	return component;
 }
 
 Ref<Entity> EntityFactory::createEntity(TextResourceFile* textResourceFile, bool isEditorOnly)
@@ -170,6 +255,7 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 	JSON::json name = entityJSON["Entity"]["name"];
 
 	EntityID newID = 0;
+	bool isPersistentID = false;
 	if (isEditorOnly)
 	{
 		newID = getNextEditorID();
@@ -180,18 +266,27 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 		if (findItID != entityJSON["Entity"].end())
 		{
 			newID = *findItID;
-			while (getNextID() <= *findItID)
+			if (newID < ROOT_ENTITY_ID || newID > ENTITY_HANDLE_MAX_ID)
 			{
-				;
+				ERR("Entity ID out of range [" + std::to_string(ROOT_ENTITY_ID) + ", " + std::to_string(ENTITY_HANDLE_MAX_ID) + "]: " + std::to_string(newID) + " in " + filePath);
+				return nullptr;
 			}
+			// IDs skipped by the file are not given out, other files being loaded may still claim them
+			s_CurrentID = std::max(s_CurrentID, newID);
+			isPersistentID = true;
 		}
 		else
 		{
 			newID = getNextID();
+			if (newID == INVALID_ID)
+			{
+				ERR("Could not create entity: " + filePath);
+				return nullptr;
+			}
 		}
 	}
 
-	entity.reset(new Entity(newID, name.is_null() ? "Entity" : name));
+	entity = MakePooledRef(new Entity(newID, name.is_null() ? "Entity" : name));
 
 	for (auto&& [componentName, componentDescription] : componentJSON.items())
 	{
@@ -210,7 +305,7 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 
 	entity->setEditorOnly(isEditorOnly);
 
-	m_Entities[entity->m_ID] = entity;
+	addEntity(entity, isPersistentID);
 
 	PRINT("Created entity: " + entity->getFullName());
 
@@ -219,33 +314,47 @@ Ref<Entity> EntityFactory::createEntity(const JSON::json& entityJSON, const Stri
 
 Ref<Entity> EntityFactory::findEntity(EntityID entityID)
 {
-	auto&& findIt = m_Entities.find(entityID);
+	EntitySlot* slot = findSlot(entityID);
+	if (slot && slot->m_EntityIndex != -1)
+	{
+		return m_Entities[slot->m_EntityIndex];
+	}
+	return nullptr;
+}
 
-	if (findIt != m_Entities.end())
+Ref<Entity> EntityFactory::findEntity(EntityHandle handle)
+{
+	EntitySlot* slot = findSlot(handle.getID());
+	if (slot && slot->m_EntityIndex != -1 && slot->m_Generation == handle.getGeneration())
 	{
-		return findIt->second;
+		return m_Entities[slot->m_EntityIndex];
 	}
 	return nullptr;
 }
 
+bool EntityFactory::isAlive(EntityHandle handle)
+{
+	EntitySlot* slot = findSlot(handle.getID());
+	return slot && slot->m_EntityIndex != -1 && slot->m_Generation == handle.getGeneration();
+}
+
 void EntityFactory::setupLiveEntities()
 {
 	for (auto& entity : m_Entities)
 	{
-		if (!entity.second->setupEntities())
+		if (!entity->setupEntities())
 		{
-			ERR("Could not setup: " + entity.second->getFullName());
+			ERR("Could not setup: " + entity->getFullName());
 		}
 	}
 }
 
 Ref<Entity> EntityFactory::createRootEntity()
 {
-	Ref<Entity> root;
-	root.reset(new Entity(ROOT_ENTITY_ID, "Root"));
+	Ref<Entity> root = MakePooledRef(new Entity(ROOT_ENTITY_ID, "Root"));
 
 	{
-		Ref<HierarchyComponent> rootComponent(new HierarchyComponent(INVALID_ID, {}));
+		Ref<HierarchyComponent> rootComponent = MakePooledRef(new HierarchyComponent(INVALID_ID, {}));
 		System::RegisterComponent(rootComponent.get());
 		addComponent(root, rootComponent);
 	}
@@ -267,7 +376,7 @@ Ref<Entity> EntityFactory::createRootEntity()
 		addComponent(root, rootListenerComponent);
 	}
 
-	m_Entities[root->m_ID] = root;
+	addEntity(root);
 	return root;
 }
 
@@ -300,14 +409,14 @@ void EntityFactory::destroyEntities()
 	Vector<Ref<Entity>> markedForRemoval;
 	for (auto& entity : m_Entities)
 	{
-		if (entity.second)
+		if (entity)
 		{
-			if (entity.second->getID() == ROOT_ENTITY_ID || entity.second->getID() == INVALID_ID || entity.second->isEditorOnly())
+			if (entity->getID() == ROOT_ENTITY_ID || entity->getID() == INVALID_ID || entity->isEditorOnly())
 			{
 				continue;
 			}
 
-			markedForRemoval.push_back(entity.second);
+			markedForRemoval.push_back(entity);
 		}
 		else
 		{
@@ -319,16 +428,12 @@ void EntityFactory::destroyEntities()
 	{
 		deleteEntity(entity, true);
 	}
-
-	Ref<Entity> root = m_Entities[ROOT_ENTITY_ID];
-	m_Entities.clear();
-	m_Entities[ROOT_ENTITY_ID] = root;
 }
 
 void EntityFactory::deleteEntity(Ref<Entity> entity, bool silentDelete)
 {
 	entity->destroy();
-	m_Entities.erase(entity->getID());
+	removeEntity(entity.get());
 	entity.reset();
 
 	if (!silentDelete)
@@ -369,10 +474,10 @@ Ref<Entity> EntityFactory::createEntitiesRecursively(Ref<Entity> entity)
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	JSON::json& entityJSON = entity->getJSON();
 	Vector<EntityID> childrenIDs;
-	for (EntityID child : hierarchyComponent->m_ChildrenIDs)
+	for (HierarchyComponent* child = hierarchyComponent->getFirstChild(); child; child = child->getNextSibling())
 	{
-		createEntitiesRecursively(findEntity(child));
-		childrenIDs.push_back(child);
+		createEntitiesRecursively(child->getOwner());
+		childrenIDs.push_back(child->getOwner()->getID());
 	}
 	entityJSON["Components"]["HierarchyComponent"]["children"] = childrenIDs;
 	entityJSON["Components"]["HierarchyComponent"]["parent"] = hierarchyComponent->m_ParentID;
@@ -390,9 +495,9 @@ String EntityFactory::saveEntityAsClassRecursively(Ref<Entity> entity, const Str
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	JSON::json& entityJSON = entity->getJSON();
 	Vector<String> children;
-	for (EntityID child : hierarchyComponent->m_ChildrenIDs)
+	for (HierarchyComponent* child = hierarchyComponent->getFirstChild(); child; child = child->getNextSibling())
 	{
-		children.push_back(saveEntityAsClassRecursively(EntityFactory::GetSingleton()->findEntity(child), path));
+		children.push_back(saveEntityAsClassRecursively(child->getOwner(), path));
 	}
 	entityJSON["Components"]["HierarchyComponent"]["children"] = children;
 	entityJSON["Components"]["HierarchyComponent"]["parent"] = ROOT_ENTITY_ID;
@@ -445,8 +550,198 @@ void EntityFactory::fixParentID(Ref<Entity> entity, EntityID id)
 	Ref<HierarchyComponent> hierarchyComponent = entity->getComponent<HierarchyComponent>();
 	hierarchyComponent->m_ParentID = id;
 	entity->setupEntities();
-	for (EntityID childID : hierarchyComponent->m_ChildrenIDs)
+	for (HierarchyComponent* child = hierarchyComponent->getFirstChild(); child; child = child->getNextSibling())
 	{
-		fixParentID(findEntity(childID), entity->getID());
+		fixParentID(child->getOwner(), entity->getID());
 	}
 }
+
+Ref<EntityPrefab> EntityFactory::compilePrefab(TextResourceFile* entityFile)
+{
+	return compilePrefab(JSON::json::parse(entityFile->getString()));
+}
+
+Ref<EntityPrefab> EntityFactory::compilePrefab(const JSON::json& entityJSON)
+{
+	Ref<EntityPrefab> prefab(new EntityPrefab());
+	if (compilePrefabNode(entityJSON, -1, *prefab) == -1)
+	{
+		ERR("Could not compile prefab: " + entityJSON["Entity"]["name"].dump());
+		return nullptr;
+	}
+	return prefab;
+}
+
+int EntityFactory::compilePrefabNode(const JSON::json& entityJSON, int parent, EntityPrefab& prefab)
+{
+	if (entityJSON.is_null() || entityJSON.find("Components") == entityJSON.end())
+	{
+		ERR("Components not found while compiling prefab");
+		return -1;
+	}
+
+	int nodeIndex = prefab.m_Nodes.size();
+	prefab.m_Nodes.emplace_back();
+	{
+		EntityPrefab::Node& node = prefab.m_Nodes.back();
+		const JSON::json& name = entityJSON["Entity"]["name"];
+		node.m_Name = name.is_null() ? "Entity" : name;
+		node.m_Parent = parent;
+		node.m_HasHierarchy = false;
+	}
+
+	Vector<String> childPaths;
+	for (auto&& [componentName, componentDescription] : entityJSON["Components"].items())
+	{
+		if (componentName == "HierarchyComponent")
+		{
+			prefab.m_Nodes[nodeIndex].m_HasHierarchy = true;
+			for (const String& path : componentDescription["children"])
+			{
+				childPaths.push_back(path);
+			}
+			continue;
+		}
+
+		int creatorIndex = getComponentCreatorIndex(componentName);
+		if (creatorIndex == -1)
+		{
+			ERR("Could not find component creator: " + componentName);
+			continue;
+		}
+		// Components that can be cloned read their JSON data only here instead of on every spawn.
+		// The others are not created at all until spawning, creating them may load resources.
+		if (Extract(bool, m_ComponentCreators[creatorIndex]))
+		{
+			ComponentCreator create = Extract(ComponentCreator, m_ComponentCreators[creatorIndex]);
+			Ref<Component> prototype = MakePooledRef(create(componentDescription));
+			if (prototype)
+			{
+				prefab.m_Nodes[nodeIndex].m_Components.push_back({ (unsigned int)creatorIndex, prototype, {} });
+				continue;
+			}
+		}
+		prefab.m_Nodes[nodeIndex].m_Components.push_back({ (unsigned int)creatorIndex, nullptr, componentDescription });
+	}
+
+	for (auto& path : childPaths)
+	{
+		if (OS::IsFile(path))
+		{
+			TextResourceFile* classFile = ResourceLoader::CreateTextResourceFile(path);
+			int childIndex = compilePrefabNode(JSON::json::parse(classFile->getString()), nodeIndex, prefab);
+			if (childIndex != -1)
+			{
+				prefab.m_Nodes[nodeIndex].m_Children.push_back(childIndex);
+			}
+		}
+	}
+
+	return nodeIndex;
+}
+
+Vector<Ref<Entity>> EntityFactory::spawnBatch(const EntityPrefab& prefab, unsigned int count, const Vector<Matrix>& transforms)
+{
+	Vector<Ref<Entity>> roots;
+	if (prefab.m_Nodes.empty())
+	{
+		return roots;
+	}
+	roots.reserve(count);
+
+	Vector<Ref<Entity>> entities;
+	entities.reserve(count * prefab.m_Nodes.size());
+	Vector<EntityID> nodeIDs(prefab.m_Nodes.size());
+
+	// Component creators register with systems and load resources, so creation stays on this thread
+	for (unsigned int i = 0; i < count; i++)
+	{
+		bool isOutOfIDs = false;
+		for (auto& nodeID : nodeIDs)
+		{
+			nodeID = getNextID();
+			isOutOfIDs = isOutOfIDs || nodeID == INVALID_ID;
+		}
+		if (isOutOfIDs)
+		{
+			// Hand back the IDs taken for this copy, the copies spawned so far are kept
+			for (auto& nodeID : nodeIDs)
+			{
+				if (nodeID != INVALID_ID)
+				{
+					m_FreeIDs.push_back(nodeID);
+				}
+			}
+			ERR("Spawned only " + std::to_string(i) + " of " + std::to_string(count) + " copies of the prefab");
+			break;
+		}
+
+		for (int n = 0; n < prefab.m_Nodes.size(); n++)
+		{
+			const EntityPrefab::Node& node = prefab.m_Nodes[n];
+			Ref<Entity> entity = MakePooledRef(new Entity(nodeIDs[n], node.m_Name));
+
+			for (auto& componentTemplate : node.m_Components)
+			{
+				Ref<Component> component;
+				if (componentTemplate.m_Prototype)
+				{
+					component = MakePooledRef(componentTemplate.m_Prototype->clone());
+					System::RegisterComponent(component.get());
+				}
+				else
+				{
+					component = createComponent(componentTemplate.m_CreatorIndex, componentTemplate.m_Data);
+				}
+				if (component)
+				{
+					entity->addComponent(component);
+					component->setOwner(entity);
+				}
+			}
+
+			if (node.m_HasHierarchy)
+			{
+				Vector<EntityID> childrenIDs;
+				for (unsigned int child : node.m_Children)
+				{
+					childrenIDs.push_back(nodeIDs[child]);
+				}
+				Ref<Component> hierarchy = MakePooledRef(new HierarchyComponent(node.m_Parent == -1 ? ROOT_ENTITY_ID : nodeIDs[node.m_Parent], childrenIDs));
+				System::RegisterComponent(hierarchy.get());
+				entity->addComponent(hierarchy);
+				hierarchy->setOwner(entity);
+			}
+
+			addEntity(entity);
+			entities.push_back(entity);
+		}
+
+		Ref<Entity>& root = entities[entities.size() - prefab.m_Nodes.size()];
+		if (i < transforms.size())
+		{
+			if (TransformComponent* transform = root->getComponentPointer<TransformComponent>())
+			{
+				transform->setTransform(transforms[i]);
+			}
+		}
+		roots.push_back(root);
+	}
+
+	// Setups log and read transform caches that aren't thread safe, so they run on this thread
+	for (auto& entity : entities)
+	{
+		if (!entity->setupComponents())
+		{
+			ERR("Entity was not setup properly: " + std::to_string(entity->getID()));
+		}
+	}
+
+	// Links entities to each other and to the root entity
+	for (auto& entity : entities)
+	{
+		entity->setupEntities();
+	}
+
+	return roots;
+}
@@ -15,27 +15,85 @@ typedef Component* (*ComponentCreator)(const JSON::json& componentDescription);
 /// Function pointer to a function that default constructs a component.
 typedef Component* (*ComponentDefaultCreator)();
 typedef int EntityID;
-/// Collection of a component, its name, and a function that constructs that component.
-typedef Vector<Tuple<ComponentID, String, ComponentCreator>> ComponentDatabase;
+/// Collection of a component, its name, a function that constructs that component, and whether the component can be cloned.
+typedef Vector<Tuple<ComponentID, String, ComponentCreator, bool>> ComponentDatabase;
 /// Collection of a component, its name, and a function that constructs a default component.
 typedef Vector<Tuple<ComponentID, String, ComponentDefaultCreator>> DefaultComponentDatabase;
 
+/// Entity class compiled once by EntityFactory::compilePrefab() so that it can be spawned many times without
+/// reading child class files, walking the class JSON or looking up component creators again.
+struct EntityPrefab
+{
+	struct ComponentTemplate
+	{
+		unsigned int m_CreatorIndex;
+		/// Created once when compiling if the component sets Component::s_IsCloneable. Spawned copies are cloned from it.
+		Ref<Component> m_Prototype;
+		/// Data of components that can't be cloned. Read again on every spawn.
+		JSON::json m_Data;
+	};
+
+	/// Entity of the class hierarchy.
+	struct Node
+	{
+		String m_Name;
+		/// Index of the parent node. -1 for the topmost node.
+		int m_Parent;
+		bool m_HasHierarchy;
+		/// Every component except HierarchyComponent, which is rebuilt for each spawned entity.
+		Vector<ComponentTemplate> m_Components;
+		Vector<unsigned int> m_Children;
+	};
+
+	/// Parents are placed before their children. The first node is the topmost entity.
+	Vector<Node> m_Nodes;
+};
+
 class EntityFactory
 {
+	/// Position of an entity in the dense entity list, looked up by EntityID.
+	struct EntitySlot
+	{
+		/// Incremented every time the entity in this slot is deleted.
+		unsigned int m_Generation = 0;
+		/// -1 if the slot is free.
+		int m_EntityIndex = -1;
+		/// Set once an entity with this ID is loaded from a file. Files refer to entities by ID, so such IDs are never reused.
+		bool m_IsPersistentID = false;
+	};
+
 	static EntityID s_CurrentID;
 	static EntityID s_CurrentEditorID;
 
-	HashMap<EntityID, Ref<Entity>> m_Entities;
+	/// All live entities, packed without holes.
+	Vector<Ref<Entity>> m_Entities;
+	/// Indexed by EntityID.
+	Vector<EntitySlot> m_Slots;
+	/// Indexed by the negated EntityID of editor only entities.
+	Vector<EntitySlot> m_EditorSlots;
+	/// EntityIDs of deleted entities that were never loaded from a file, ready to be given out again.
+	Vector<EntityID> m_FreeIDs;
 
+	/// Returns INVALID_ID if every ID up to ENTITY_HANDLE_MAX_ID is in use.
 	EntityID getNextID();
 	EntityID getNextEditorID();
+	/// Returns nullptr if the ID is out of range of the slots.
+	EntitySlot* findSlot(EntityID entityID);
+	/// Make the entity findable by its ID and hand it a handle. isPersistentID marks IDs read from files.
+	void addEntity(const Ref<Entity>& entity, bool isPersistentID = false);
+	/// Free the slot of the entity and swap the last entity into its place in the entity list.
+	void removeEntity(Entity* entity);
 	String saveEntityAsClassRecursively(Ref<Entity> entity, const String& path);
 	Ref<Entity> createEntityHierarchyFromClass(JSON::json entityJSON);
 	void fixParentID(Ref<Entity> entity, EntityID id);
+	/// Append the node for the entity class and all of its children to the prefab. Returns the index of the node.
+	int compilePrefabNode(const JSON::json& entityJSON, int parent, EntityPrefab& prefab);
 
 protected:
 	ComponentDatabase m_ComponentCreators;
 	DefaultComponentDatabase m_DefaultComponentCreators;
+	/// Position of each component name in both the component databases.
+	HashMap<String, unsigned int> m_ComponentCreatorIndices;
 
 	EntityFactory();
 	EntityFactory(EntityFactory&) = delete;
@@ -51,12 +109,21 @@ public:
 	static void RegisterAPI(sol::table& rootex);
 	static EntityFactory* GetSingleton();
 
+	/// Returns -1 if no component is registered with the name.
+	int getComponentCreatorIndex(const String& name) const;
 	Ref<Component> createComponent(const String& name, const JSON::json& componentData);
+	/// Skips the name lookup. Creator indices follow the order of registration and can be stored in binary formats.
+	Ref<Component> createComponent(unsigned int creatorIndex, const JSON::json& componentData);
 	Ref<Component> createDefaultComponent(const String& name);
+	Ref<Component> createDefaultComponent(unsigned int creatorIndex);
 	Ref<Entity> createEntity(const JSON::json& entityJSON, const String& filePath, bool isEditorOnly = false);
 	Ref<Entity> createEntity(TextResourceFile* textResourceFile, bool isEditorOnly = false);
 	/// Get entity by ID.
 	Ref<Entity> findEntity(EntityID entityID);
+	/// Get entity by handle. Returns nullptr if the entity has been deleted.
+	Ref<Entity> findEntity(EntityHandle handle);
+	/// Returns true if the entity referred by the handle is not deleted yet.
+	bool isAlive(EntityHandle handle);
 
 	void setupLiveEntities();
 
@@ -70,8 +137,14 @@ public:
 	Ref<Entity> createEntitiesRecursively(Ref<Entity> entity);
 	Ref<Entity> createEntityFromClass(const JSON::json& entityJSON);
 	Ref<Entity> createEntityFromClass(TextResourceFile* entityJSON);
+	/// Compile an entity class for spawnBatch(). Returns nullptr if the class could not be read.
+	Ref<EntityPrefab> compilePrefab(const JSON::json& entityJSON);
+	Ref<EntityPrefab> compilePrefab(TextResourceFile* entityFile);
+	/// Create count copies of the prefab as children of the root entity. Returns the topmost entity of each copy.
+	/// The local transform of the topmost entity of the i-th copy is set to transforms[i] if transforms are given.
+	/// Spawns fewer copies if entity IDs run out.
+	Vector<Ref<Entity>> spawnBatch(const EntityPrefab& prefab, unsigned int count, const Vector<Matrix>& transforms = {});
 
 	const ComponentDatabase& getComponentDatabase() const { return m_ComponentCreators; }
-	const HashMap<EntityID, Ref<Entity>>& getEntities() const { return m_Entities; }
-	HashMap<EntityID, Ref<Entity>>& getMutableEntities() { return m_Entities; }
+	const Vector<Ref<Entity>>& getEntities() const { return m_Entities; }
 };
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common/common.h"
+
+/// Entries in each chunk of a PackedStorage. A power of 2, so that finding the chunk of an entry is a shift.
+#define PACKED_STORAGE_CHUNK_SIZE 256
+
+/// Data of every component of one type packed into fixed size chunks, so that systems walk contiguous arrays instead of chasing a pointer per component.
+/// Chunks never move, so adding entries leaves the existing ones in place. Removing an entry moves the last entry into the hole.
+/// OwnerType needs DataType* m_PackedData and unsigned int m_PackedIndex members, which the storage keeps pointing at the entry of each owner.
+/// Entries are added and removed on the main thread only, while no system is walking the storage.
+template <class DataType, class OwnerType>
+class PackedStorage
+{
+	struct Chunk
+	{
+		DataType m_Data[PACKED_STORAGE_CHUNK_SIZE];
+		OwnerType* m_Owners[PACKED_STORAGE_CHUNK_SIZE];
+	};
+
+	/// Emptied chunks are kept for reuse.
+	Vector<Ptr<Chunk>> m_Chunks;
+	unsigned int m_Size;
+
+	Chunk& getChunk(unsigned int index) { return *m_Chunks[index / PACKED_STORAGE_CHUNK_SIZE]; }
+
+public:
+	PackedStorage()
+	    : m_Size(0)
+	{
+	}
+	PackedStorage(PackedStorage&) = delete;
+	~PackedStorage() = default;
+
+	/// Add an entry holding data and point owner at it.
+	void add(OwnerType* owner, const DataType& data);
+	/// Remove the entry of owner.
+	void remove(OwnerType* owner);
+
+	/// Call callable(DataType* data, OwnerType* const* owners, unsigned int count) for every chunk in use, with the number of entries used in that chunk.
+	template <class Callable>
+	void eachChunk(Callable&& callable);
+
+	unsigned int size() const { return m_Size; }
+};
+
+template <class DataType, class OwnerType>
+inline void PackedStorage<DataType, OwnerType>::add(OwnerType* owner, const DataType& data)
+{
+	if (m_Size == m_Chunks.size() * PACKED_STORAGE_CHUNK_SIZE)
+	{
+		m_Chunks.emplace_back(new Chunk());
+	}
+
+	Chunk& chunk = getChunk(m_Size);
+	unsigned int slot = m_Size % PACKED_STORAGE_CHUNK_SIZE;
+	chunk.m_Data[slot] = data;
+	chunk.m_Owners[slot] = owner;
+	owner->m_PackedData = &chunk.m_Data[slot];
+	owner->m_PackedIndex = m_Size;
+	m_Size++;
+}
+
+template <class DataType, class OwnerType>
+inline void PackedStorage<DataType, OwnerType>::remove(OwnerType* owner)
+{
+	unsigned int index = owner->m_PackedIndex;
+	if (index >= m_Size || getChunk(index).m_Owners[index % PACKED_STORAGE_CHUNK_SIZE] != owner)
+	{
+		ERR("Found an entry that is not in the packed storage queued for removal");
+		return;
+	}
+
+	// Fill the hole with the last entry instead of shifting every entry after it
+	unsigned int last = m_Size - 1;
+	if (index != last)
+	{
+		Chunk& chunk = getChunk(index);
+		Chunk& lastChunk = getChunk(last);
+		unsigned int slot = index % PACKED_STORAGE_CHUNK_SIZE;
+		unsigned int lastSlot = last % PACKED_STORAGE_CHUNK_SIZE;
+
+		chunk.m_Data[slot] = lastChunk.m_Data[lastSlot];
+		chunk.m_Owners[slot] = lastChunk.m_Owners[lastSlot];
+		chunk.m_Owners[slot]->m_PackedData = &chunk.m_Data[slot];
+		chunk.m_Owners[slot]->m_PackedIndex = index;
+	}
+	m_Size--;
+
+	owner->m_PackedData = nullptr;
+	owner->m_PackedIndex = -1;
+}
+
+template <class DataType, class OwnerType>
+template <class Callable>
+inline void PackedStorage<DataType, OwnerType>::eachChunk(Callable&& callable)
+{
+	for (unsigned int begin = 0; begin < m_Size; begin += PACKED_STORAGE_CHUNK_SIZE)
+	{
+		Chunk& chunk = getChunk(begin);
+		callable(chunk.m_Data, chunk.m_Owners, std::min(m_Size - begin, (unsigned int)PACKED_STORAGE_CHUNK_SIZE));
+	}
+}
@@ -0,0 +1,80 @@
+#include "pool_allocator.h"
+
+BlockPool::BlockPool(size_t blockSize)
+    : m_BlockSize(blockSize)
+    , m_FreeList(nullptr)
+    , m_UsedBlocks(0)
+{
+}
+
+void BlockPool::addSlab()
+{
+	m_Slabs.emplace_back(new char[POOL_SLAB_SIZE]);
+	char* slab = m_Slabs.back().get();
+	for (size_t offset = 0; offset + m_BlockSize <= POOL_SLAB_SIZE; offset += m_BlockSize)
+	{
+		FreeBlock* block = (FreeBlock*)(slab + offset);
+		block->m_Next = m_FreeList;
+		m_FreeList = block;
+	}
+}
+
+void* BlockPool::allocate()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (!m_FreeList)
+	{
+		addSlab();
+	}
+
+	FreeBlock* block = m_FreeList;
+	m_FreeList = block->m_Next;
+	m_UsedBlocks++;
+	return block;
+}
+
+void BlockPool::deallocate(void* block)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	FreeBlock* freeBlock = (FreeBlock*)block;
+	freeBlock->m_Next = m_FreeList;
+	m_FreeList = freeBlock;
+	m_UsedBlocks--;
+}
+
+Vector<Ptr<BlockPool>>& PoolAllocator::GetPools()
+{
+	// Never destroyed so that objects outliving the other statics can still be freed
+	static Vector<Ptr<BlockPool>>* pools = []() {
+		Vector<Ptr<BlockPool>>* pools = new Vector<Ptr<BlockPool>>();
+		for (size_t size = POOL_BLOCK_ALIGNMENT; size <= POOL_MAX_BLOCK_SIZE; size += POOL_BLOCK_ALIGNMENT)
+		{
+			pools->emplace_back(new BlockPool(size));
+		}
+		return pools;
+	}();
+	return *pools;
+}
+
+void* PoolAllocator::Allocate(size_t size)
+{
+	if (size == 0 || size > POOL_MAX_BLOCK_SIZE)
+	{
+		return ::operator new(size);
+	}
+	return GetPools()[(size - 1) / POOL_BLOCK_ALIGNMENT]->allocate();
+}
+
+void PoolAllocator::Deallocate(void* block, size_t size)
+{
+	if (!block)
+	{
+		return;
+	}
+	if (size == 0 || size > POOL_MAX_BLOCK_SIZE)
+	{
+		::operator delete(block);
+		return;
+	}
+	GetPools()[(size - 1) / POOL_BLOCK_ALIGNMENT]->deallocate(block);
+}
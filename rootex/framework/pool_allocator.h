@@ -0,0 +1,91 @@
+#pragma once
+
+#include "common/common.h"
+
+#include <mutex>
+
+/// Size of the blocks handed out by the smallest pool. Every pool hands out a multiple of this.
+#define POOL_BLOCK_ALIGNMENT 16
+/// Allocations larger than this are not pooled.
+#define POOL_MAX_BLOCK_SIZE 1024
+/// Memory reserved by a pool at once.
+#define POOL_SLAB_SIZE (64 * 1024)
+
+/// Hands out blocks of a single size carved from large slabs.
+/// Freed blocks are kept in a free list and reused, slabs are never given back to the OS.
+class BlockPool
+{
+	/// Freed block. Links are stored inside the freed memory itself.
+	struct FreeBlock
+	{
+		FreeBlock* m_Next;
+	};
+
+	size_t m_BlockSize;
+	Vector<Ptr<char[]>> m_Slabs;
+	FreeBlock* m_FreeList;
+	Atomic<unsigned int> m_UsedBlocks;
+	std::mutex m_Mutex;
+
+	void addSlab();
+
+public:
+	BlockPool(size_t blockSize);
+	BlockPool(BlockPool&) = delete;
+	~BlockPool() = default;
+
+	void* allocate();
+	void deallocate(void* block);
+
+	size_t getBlockSize() const { return m_BlockSize; }
+	size_t getReservedBytes() const { return m_Slabs.size() * POOL_SLAB_SIZE; }
+	unsigned int getUsedBlocks() const { return m_UsedBlocks.load(); }
+};
+
+/// Pools for every block size up to POOL_MAX_BLOCK_SIZE. Used for components and entities so that level loads
+/// don't scatter lots of small allocations across the heap.
+class PoolAllocator
+{
+	static Vector<Ptr<BlockPool>>& GetPools();
+
+public:
+	/// Thread safe. Falls back to operator new for sizes above POOL_MAX_BLOCK_SIZE.
+	static void* Allocate(size_t size);
+	/// size should be the same as the one passed to Allocate().
+	static void Deallocate(void* block, size_t size);
+
+	static const Vector<Ptr<BlockPool>>& GetBlockPools() { return GetPools(); }
+};
+
+/// STL style allocator over PoolAllocator. Pass this to a Ref constructor to pool its control block too.
+template <class T>
+class PoolSTLAllocator
+{
+public:
+	typedef T value_type;
+
+	PoolSTLAllocator() = default;
+	template <class U>
+	PoolSTLAllocator(const PoolSTLAllocator<U>&) { }
+
+	T* allocate(size_t count) { return (T*)PoolAllocator::Allocate(count * sizeof(T)); }
+	void deallocate(T* block, size_t count) { PoolAllocator::Deallocate(block, count * sizeof(T)); }
+
+	template <class U>
+	bool operator==(const PoolSTLAllocator<U>&) const { return true; }
+	template <class U>
+	bool operator!=(const PoolSTLAllocator<U>&) const { return false; }
+};
+
+/// Wrap a pooled object in a Ref whose control block is pooled as well.
+template <class T>
+inline Ref<T> MakePooledRef(T* object)
+{
+	return Ref<T>(object, std::default_delete<T>(), PoolSTLAllocator<T>());
+}
+
+/// Add to a class to allocate the class and all classes deriving from it from the pools.
+/// The class should have a virtual destructor so that the size of the derived class reaches operator delete.
+#define POOL_ALLOCATED_CLASS                                                                         \
+	static void* operator new(size_t size) { return PoolAllocator::Allocate(size); }               \
+	static void operator delete(void* block, size_t size) { PoolAllocator::Deallocate(block, size); }
@@ -5,27 +5,105 @@ Map<System::UpdateOrder, Vector<System*>> System::s_Systems;
 
 void System::RegisterComponent(Component* component)
 {
-	s_Components[component->getComponentID()].push_back(component);
+	Vector<Component*>& components = s_Components[component->getComponentID()];
+	component->m_SystemIndex = components.size();
+	components.push_back(component);
 }
 
 void System::DeregisterComponent(Component* component)
 {
 	Vector<Component*>& components = s_Components[component->getComponentID()];
 
-	auto findIt = std::find(components.begin(), components.end(), component);
-	if (findIt != components.end())
+	int index = component->m_SystemIndex;
+	if (index < 0 || index >= components.size() || components[index] != component)
+	{
+		ERR("Found an unregistered component queued for deregisteration: " + component->getName());
+		return;
+	}
+
+	// Fill the hole with the last component instead of shifting every component after it
+	components[index] = components.back();
+	components[index]->m_SystemIndex = index;
+	components.pop_back();
+	component->m_SystemIndex = -1;
+}
+
+void System::UpdateParallel(ThreadPool& threadPool, const Vector<System*>& systems, float deltaMilliseconds)
+{
+	if (systems.empty())
 	{
-		components.erase(findIt);
+		return;
 	}
-	else
+	if (systems.size() == 1)
 	{
-		ERR("Found an unregistered component queued for deregisteration: " + component->getName());
+		systems.front()->update(deltaMilliseconds);
+		return;
+	}
+
+	Vector<Ref<Task>> tasks;
+	for (int i = 0; i < systems.size(); i++)
+	{
+		System* system = systems[i];
+		tasks.emplace_back(new Task([system, deltaMilliseconds]() { system->update(deltaMilliseconds); }));
+		for (int j = 0; j < i; j++)
+		{
+			if (systems[j]->isConflicting(system))
+			{
+				tasks[j]->addContinuation(tasks[i]);
+			}
+		}
+	}
+
+	threadPool.wait(threadPool.submit(tasks));
+}
+
+Vector<Vector<System*>> System::GetUpdateStages()
+{
+	Vector<Vector<System*>> stages;
+	for (auto& [order, systems] : s_Systems)
+	{
+		Vector<System*> parallelSystems;
+		for (auto& system : systems)
+		{
+			if (!system->isActive())
+			{
+				continue;
+			}
+
+			if (system->isAccessDeclared())
+			{
+				parallelSystems.push_back(system);
+			}
+			else
+			{
+				if (!parallelSystems.empty())
+				{
+					stages.push_back(parallelSystems);
+					parallelSystems.clear();
+				}
+				stages.push_back({ system });
+			}
+		}
+		if (!parallelSystems.empty())
+		{
+			stages.push_back(parallelSystems);
+		}
+	}
+	return stages;
+}
+
+void System::UpdateSystems(ThreadPool& threadPool, float deltaMilliseconds)
+{
+	for (auto& stage : GetUpdateStages())
+	{
+		UpdateParallel(threadPool, stage, deltaMilliseconds);
 	}
 }
 
 System::System(const String& name, const UpdateOrder& order, bool isGameplay)
     : m_SystemName(name)
     , m_UpdateOrder(order)
+    , m_IsAccessDeclared(false)
 {
 	s_Systems[order].push_back(this);
 	setActive(isGameplay);
@@ -67,6 +145,45 @@ void System::setActive(bool enabled)
 	m_IsActive = enabled;
 }
 
+void System::declareAccess(const Vector<ComponentID>& reads, const Vector<ComponentID>& writes)
+{
+	m_ReadComponents = reads;
+	m_WriteComponents = writes;
+	m_IsAccessDeclared = true;
+
+	// Create the component lists up front so that lookups from worker threads never insert into s_Components
+	for (auto& componentID : reads)
+	{
+		s_Components[componentID];
+	}
+	for (auto& componentID : writes)
+	{
+		s_Components[componentID];
+	}
+}
+
+bool System::isConflicting(const System* other) const
+{
+	if (!m_IsAccessDeclared || !other->m_IsAccessDeclared)
+	{
+		return true;
+	}
+
+	auto isAccessedBy = [](const Vector<ComponentID>& writes, const System* system) {
+		for (auto& write : writes)
+		{
+			if (std::find(system->m_ReadComponents.begin(), system->m_ReadComponents.end(), write) != system->m_ReadComponents.end()
+			    || std::find(system->m_WriteComponents.begin(), system->m_WriteComponents.end(), write) != system->m_WriteComponents.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	return isAccessedBy(m_WriteComponents, other) || isAccessedBy(other->m_WriteComponents, this);
+}
+
 #ifdef ROOTEX_EDITOR
 #include "imgui.h"
 void System::draw()
@@ -4,6 +4,7 @@
 
 #include "entity.h"
 #include "component.h"
+#include "os/thread.h"
 
 /// ECS style System interface that allows iterating over components directly.
 class System
@@ -23,9 +24,13 @@ public:
 
 protected:
 	static Map<UpdateOrder, Vector<System*>> s_Systems;
+	/// Components of each type in no particular order. Systems should not reorder these lists in place.
 	static HashMap<ComponentID, Vector<Component*>> s_Components;
 	static void RegisterComponent(Component* component);
+	/// Swaps the last component of the same type into the place of the removed one.
 	static void DeregisterComponent(Component* component);
+	/// Update systems in parallel, making systems wait for earlier conflicting systems.
+	static void UpdateParallel(ThreadPool& threadPool, const Vector<System*>& systems, float deltaMilliseconds);
 	
 	friend class Entity;
 	friend class EntityFactory;
@@ -34,9 +39,23 @@ protected:
 	UpdateOrder m_UpdateOrder;
 	bool m_IsActive;
 
+	/// Systems that don't declare the components they access are updated alone on the main thread.
+	bool m_IsAccessDeclared;
+	Vector<ComponentID> m_ReadComponents;
+	Vector<ComponentID> m_WriteComponents;
+
+	/// Declare the only components this system reads and writes in update(). Lets the system update on worker threads.
+	/// Systems that call into Lua, OpenAL or Direct3D, or use other state that isn't thread safe, should not declare their access.
+	void declareAccess(const Vector<ComponentID>& reads, const Vector<ComponentID>& writes);
+
 public:
 	static const Map<UpdateOrder, Vector<System*>>& GetSystems() { return s_Systems; }
 	static const Vector<Component*>& GetComponents(ComponentID ID) { return s_Components[ID]; }
+	/// Active systems grouped the way UpdateSystems() updates them. Stages are updated one after another.
+	/// A system that hasn't declared its access is a stage of its own. Neighbouring systems of the same update order that have declared their access share a stage.
+	static Vector<Vector<System*>> GetUpdateStages();
+	/// Update all active systems in order. Systems in the same stage with non-conflicting component access run concurrently.
+	static void UpdateSystems(ThreadPool& threadPool, float deltaMilliseconds);
 	
 	System(const String& name, const UpdateOrder& order, bool isGameplay);
 	System(System&) = delete;
@@ -51,6 +70,9 @@ public:
 	String getName() const { return m_SystemName; }
 	const UpdateOrder& getUpdateOrder() const { return m_UpdateOrder; }
 	bool isActive() const { return m_IsActive; }
+	bool isAccessDeclared() const { return m_IsAccessDeclared; }
+	/// Returns true if either system writes components that the other one accesses.
+	bool isConflicting(const System* other) const;
 
 	void setActive(bool enabled);
 
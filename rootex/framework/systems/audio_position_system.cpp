@@ -0,0 +1,33 @@
+#include "audio_position_system.h"
+
+#include "components/audio_component.h"
+#include "components/audio_listener_component.h"
+#include "components/transform_component.h"
+#include "systems/audio_system.h"
+
+AudioPositionSystem::AudioPositionSystem()
+    : System("AudioPositionSystem", UpdateOrder::Update, true)
+{
+	declareAccess({ TransformComponent::s_ID }, { AudioComponent::s_ID, AudioListenerComponent::s_ID });
+}
+
+AudioPositionSystem* AudioPositionSystem::GetSingleton()
+{
+	static AudioPositionSystem singleton;
+	return &singleton;
+}
+
+void AudioPositionSystem::update(float deltaMilliseconds)
+{
+	AudioComponent* audioComponent = nullptr;
+	for (Component* component : s_Components[AudioComponent::s_ID])
+	{
+		audioComponent = (AudioComponent*)component;
+		audioComponent->updatePosition();
+	}
+
+	if (AudioListenerComponent* listener = AudioSystem::GetSingleton()->getListener())
+	{
+		listener->updatePosition();
+	}
+}
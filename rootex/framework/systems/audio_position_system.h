@@ -0,0 +1,17 @@
+#pragma once
+
+#include "system.h"
+
+/// Copies the world positions of audio sources and the listener out of their transforms before AudioSystem hands them to OpenAL.
+/// Only reads transforms and writes audio components, so it runs on worker threads alongside other systems.
+class AudioPositionSystem : public System
+{
+	AudioPositionSystem();
+	AudioPositionSystem(AudioPositionSystem&) = delete;
+	~AudioPositionSystem() = default;
+
+public:
+	static AudioPositionSystem* GetSingleton();
+
+	void update(float deltaMilliseconds) override;
+};
@@ -5,14 +5,12 @@
 InputSystem::InputSystem()
     : System("InputSystem", UpdateOrder::Input, true)
 {
-	BIND_EVENT_MEMBER_FUNCTION("WindowResized", InputSystem::windowResized);
+	BIND_TYPED_EVENT_MEMBER_FUNCTION(WindowResized, InputSystem::windowResized);
 }
 
-Variant InputSystem::windowResized(const Event* event)
+void InputSystem::windowResized(const WindowResized& resized)
 {
-	const Vector2& newSize = Extract(Vector2, event->getData());
-	InputManager::GetSingleton()->setDisplaySize(newSize);
-	return true;
+	InputManager::GetSingleton()->setDisplaySize(resized.m_Size);
 }
 
 InputSystem* InputSystem::GetSingleton()
@@ -2,6 +2,7 @@
 
 #include "system.h"
 #include "event_manager.h"
+#include "main/window.h"
 
 class InputSystem : public System
 {
@@ -9,7 +10,7 @@ class InputSystem : public System
 	InputSystem(InputSystem&) = delete;
 	~InputSystem() = default;
 
-	Variant windowResized(const Event* event);
+	void windowResized(const WindowResized& resized);
 
 public:
 	static InputSystem* GetSingleton();
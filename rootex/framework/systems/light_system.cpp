@@ -1,16 +1,15 @@
 #include "light_system.h"
 
 #include "core/renderer/shaders/register_locations_pixel_shader.h"
-#include "components/visual/point_light_component.h"
-#include "components/visual/static_point_light_component.h"
-#include "components/visual/directional_light_component.h"
-#include "components/visual/spot_light_component.h"
-#include "components/transform_component.h"
 #include "framework/systems/render_system.h"
 
 LightSystem::LightSystem()
-    : System("LightSystem", UpdateOrder::Async, false)
+    : System("LightSystem", UpdateOrder::Update, true)
+    , m_DirectionalLightCount(0)
 {
+	declareAccess(
+	    { TransformComponent::s_ID, CameraComponent::s_ID, PointLightComponent::s_ID, DirectionalLightComponent::s_ID, SpotLightComponent::s_ID },
+	    {});
 }
 
 LightSystem* LightSystem::GetSingleton()
@@ -22,13 +21,14 @@ LightSystem* LightSystem::GetSingleton()
 StaticPointLightsInfo LightSystem::getStaticPointLights()
 {
 	StaticPointLightsInfo staticLights;
-	Vector<Component*>& staticPointLightComponents = s_Components[StaticPointLightComponent::s_ID];
 
 	int i = 0;
-	for (; i < staticPointLightComponents.size() && i < MAX_STATIC_POINT_LIGHTS; i++)
-	{
-		StaticPointLightComponent* staticLight = (StaticPointLightComponent*)staticPointLightComponents[i];
-		TransformComponent* transform = staticLight->getOwner()->getComponent<TransformComponent>().get();
+	m_StaticPointLights.each([&](Entity* entity, TransformComponent* transform, StaticPointLightComponent* staticLight) {
+		if (i >= MAX_STATIC_POINT_LIGHTS)
+		{
+			return;
+		}
+
 		Vector3 transformedPosition = transform->getAbsoluteTransform().Translation();
 		const PointLight& pointLight = staticLight->getPointLight();
 
@@ -40,33 +40,51 @@ StaticPointLightsInfo LightSystem::getStaticPointLights()
 		staticLights.pointLightInfos[i].attQuad = pointLight.attQuad;
 		staticLights.pointLightInfos[i].lightPos = transformedPosition;
 		staticLights.pointLightInfos[i].range = pointLight.range;
-	}
+		i++;
+	});
 	return staticLights;
 }
 
-LightsInfo LightSystem::getDynamicLights()
+const LightsInfo& LightSystem::getDynamicLights()
+{
+	// Logged here because update() may run on a worker thread
+	if (m_DirectionalLightCount > 1)
+	{
+		WARN("Directional lights specified are greater than 1. Using only the first directional light found.");
+	}
+	return m_DynamicLights;
+}
+
+void LightSystem::update(float deltaMilliseconds)
 {
 	LightsInfo lights;
 	
 	Vector3 cameraPos = RenderSystem::GetSingleton()->getCamera()->getAbsolutePosition();
 	lights.cameraPos = cameraPos;
 
-	static auto sortingLambda = [&cameraPos](const Component* a, const Component* b) -> bool {
-		Vector3& aa = a->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
-		Vector3& bb = b->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform().Translation();
-		return Vector3::DistanceSquared(cameraPos, aa) < Vector3::DistanceSquared(cameraPos, bb);
-	};
-
-	Vector<Component*>& pointLightComponents = s_Components[PointLightComponent::s_ID];
-	sort(pointLightComponents.begin(), pointLightComponents.end(), sortingLambda);
+	// Light settings are read straight out of the packed arrays, only the positions are looked up per light
+	Vector<Tuple<float, Vector3, const PointLight*>> pointLights;
+	PointLightComponent::GetPackedPointLights().eachChunk([&](PointLight* settings, PointLightComponent* const* owners, unsigned int count) {
+		for (unsigned int l = 0; l < count; l++)
+		{
+			Entity* entity = owners[l]->getOwnerPointer();
+			TransformComponent* transform = entity ? entity->getComponentPointer<TransformComponent>() : nullptr;
+			if (!transform)
+			{
+				continue;
+			}
+
+			Vector3 position = transform->getAbsoluteTransform().Translation();
+			pointLights.push_back({ Vector3::DistanceSquared(cameraPos, position), position, &settings[l] });
+		}
+	});
+	std::sort(pointLights.begin(), pointLights.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
 
 	int i = 0;
-	for (; i < pointLightComponents.size() && i < MAX_DYNAMIC_POINT_LIGHTS; i++)
+	for (; i < pointLights.size() && i < MAX_DYNAMIC_POINT_LIGHTS; i++)
 	{
-		PointLightComponent* light = (PointLightComponent*)pointLightComponents[i];
-		TransformComponent* transform = light->getOwner()->getComponent<TransformComponent>().get();
-		Vector3 transformedPosition = transform->getAbsoluteTransform().Translation();
-		const PointLight& pointLight = light->getPointLight();
+		auto [distance, transformedPosition, light] = pointLights[i];
+		const PointLight& pointLight = *light;
 		
 		lights.pointLightInfos[i].ambientColor = pointLight.ambientColor;
 		lights.pointLightInfos[i].diffuseColor = pointLight.diffuseColor;
@@ -79,18 +97,15 @@ LightsInfo LightSystem::getDynamicLights()
 	}
 	lights.pointLightCount = i;
 
-	const Vector<Component*>& directionalLightComponents = s_Components[DirectionalLightComponent::s_ID];
-
-	if (directionalLightComponents.size() > 1)
-	{
-		WARN("Directional lights specified are greater than 1. Using only the first directional light found.");
-	}
+	m_DirectionalLightCount = m_DirectionalLights.size();
+	m_DirectionalLights.each([&](Entity* entity, TransformComponent* transformComponent, DirectionalLightComponent* light) {
+		if (lights.directionalLightPresent)
+		{
+			return;
+		}
 
-	if (directionalLightComponents.size() > 0)
-	{
-		DirectionalLightComponent* light = (DirectionalLightComponent*)directionalLightComponents[0];
 		const DirectionalLight& directionalLight = light->getDirectionalLight();
-		Matrix transform = light->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform();
+		Matrix transform = transformComponent->getAbsoluteTransform();
 
 		lights.directionalLightInfo = {
 			transform.Forward(), 
@@ -99,16 +114,20 @@ LightsInfo LightSystem::getDynamicLights()
 			directionalLight.ambientColor
 		};
 		lights.directionalLightPresent = 1;
-	}
+	});
 
-	Vector<Component*>& spotLightComponents = s_Components[SpotLightComponent::s_ID];
-	sort(spotLightComponents.begin(), spotLightComponents.end(), sortingLambda);
+	Vector<Tuple<float, TransformComponent*, SpotLightComponent*>> spotLights;
+	m_SpotLights.each([&](Entity* entity, TransformComponent* transform, SpotLightComponent* light) {
+		float distance = Vector3::DistanceSquared(cameraPos, transform->getAbsoluteTransform().Translation());
+		spotLights.push_back({ distance, transform, light });
+	});
+	std::sort(spotLights.begin(), spotLights.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
 
 	i = 0;
-	for (; i < spotLightComponents.size() && i < MAX_DYNAMIC_SPOT_LIGHTS; i++)
+	for (; i < spotLights.size() && i < MAX_DYNAMIC_SPOT_LIGHTS; i++)
 	{
-		SpotLightComponent* light = (SpotLightComponent*)spotLightComponents[i];
-		Matrix transform = light->getOwner()->getComponent<TransformComponent>()->getAbsoluteTransform();
+		auto [distance, transformComponent, light] = spotLights[i];
+		Matrix transform = transformComponent->getAbsoluteTransform();
 		const SpotLight& spotLight = light->getSpotLight();
 
 		lights.spotLightInfos[i] = {
@@ -127,5 +146,5 @@ LightsInfo LightSystem::getDynamicLights()
 	}
 	lights.spotLightCount = i;
 
-	return lights;
+	m_DynamicLights = lights;
 }
@@ -1,16 +1,34 @@
 #pragma once
 
 #include "system.h"
+#include "view.h"
 #include "renderer/constant_buffer.h"
+#include "components/transform_component.h"
+#include "components/visual/point_light_component.h"
+#include "components/visual/static_point_light_component.h"
+#include "components/visual/directional_light_component.h"
+#include "components/visual/spot_light_component.h"
 
 /// Interface for setting up point, directional and spot lights.
 class LightSystem : public System
 {
+	View<TransformComponent, StaticPointLightComponent> m_StaticPointLights;
+	View<TransformComponent, DirectionalLightComponent> m_DirectionalLights;
+	View<TransformComponent, SpotLightComponent> m_SpotLights;
+
+	/// Gathered by update() for RenderSystem to upload.
+	LightsInfo m_DynamicLights;
+	size_t m_DirectionalLightCount;
+
 	LightSystem();
 
 public:
 	static LightSystem* GetSingleton();
 
+	/// Gather the dynamic lights closest to the camera. Only reads components, so it runs on worker threads alongside other systems.
+	void update(float deltaMilliseconds) override;
+
 	StaticPointLightsInfo getStaticPointLights();
-	LightsInfo getDynamicLights();
+	/// Dynamic lights gathered by the last update.
+	const LightsInfo& getDynamicLights();
 };
@@ -6,6 +6,7 @@
 #include "light_system.h"
 #include "renderer/material_library.h"
 #include "components/visual/sky_component.h"
+#include "components/transform_hierarchy.h"
 #include "application.h"
 
 RenderSystem* RenderSystem::GetSingleton()
@@ -67,13 +68,7 @@ void RenderSystem::setConfig(const JSON::json& configData, bool openInEditor)
 
 void RenderSystem::calculateTransforms(HierarchyComponent* hierarchyComponent)
 {
-	pushMatrix(hierarchyComponent->getOwner()->getComponent<TransformComponent>()->getLocalTransform());
-	for (auto&& child : hierarchyComponent->getChildren())
-	{
-		child->getOwner()->getComponent<TransformComponent>()->m_ParentAbsoluteTransform = getCurrentMatrix();
-		calculateTransforms(child);
-	}
-	popMatrix();
+	TransformHierarchy::Update(hierarchyComponent);
 }
 
 void RenderSystem::renderPassRender(float deltaMilliseconds, RenderPass renderPass)
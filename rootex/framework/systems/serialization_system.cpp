@@ -35,10 +35,10 @@ void SerializationSystem::saveAllEntities(const String& dirPath)
 
 	for (auto&& entity : EntityFactory::GetSingleton()->getEntities())
 	{
-		if (entity.second->getID() != ROOT_ENTITY_ID && !entity.second->isEditorOnly())
+		if (entity->getID() != ROOT_ENTITY_ID && !entity->isEditorOnly())
 		{
-			InputOutputFileStream file = OS::CreateFileName(cachePath + "/" + entity.second->getFullName() + ".entity.json");
-			file << std::setw(4) << entity.second->getJSON() << std::endl;
+			InputOutputFileStream file = OS::CreateFileName(cachePath + "/" + entity->getFullName() + ".entity.json");
+			file << std::setw(4) << entity->getJSON() << std::endl;
 		}
 	}
 
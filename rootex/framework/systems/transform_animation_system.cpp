@@ -1,6 +1,8 @@
 #include "transform_animation_system.h"
 
+#include "app/application.h"
 #include "components/transform_animation_component.h"
+#include "components/transform_component.h"
 
 TransformAnimationSystem* TransformAnimationSystem::GetSingleton()
 {
@@ -11,6 +13,7 @@ TransformAnimationSystem* TransformAnimationSystem::GetSingleton()
 TransformAnimationSystem::TransformAnimationSystem()
     : System("TransformationAnimationSystem", UpdateOrder::Update, true)
 {
+	declareAccess({}, { TransformAnimationComponent::s_ID, TransformComponent::s_ID });
 }
 
 void TransformAnimationSystem::begin()
@@ -29,14 +32,17 @@ void TransformAnimationSystem::begin()
 
 void TransformAnimationSystem::update(float deltaMilliseconds)
 {
-	TransformAnimationComponent* animation = nullptr;
-	for (auto& component : s_Components[TransformAnimationComponent::s_ID])
-	{
-		animation = (TransformAnimationComponent*)component;
-
-		if (animation->isPlaying() && !animation->hasEnded())
+	const Vector<Component*>& animations = s_Components[TransformAnimationComponent::s_ID];
+	Application::GetSingleton()->getThreadPool().parallelFor(animations.size(), [&animations, deltaMilliseconds](size_t begin, size_t end) {
+		TransformAnimationComponent* animation = nullptr;
+		for (size_t i = begin; i < end; i++)
 		{
-			animation->interpolate(deltaMilliseconds * MS_TO_S);
+			animation = (TransformAnimationComponent*)animations[i];
+
+			if (animation->isPlaying() && !animation->hasEnded())
+			{
+				animation->interpolate(deltaMilliseconds * MS_TO_S);
+			}
 		}
-	}
+	});
 }
@@ -0,0 +1,36 @@
+#include "view.h"
+
+Vector<ViewBase*> ViewBase::s_Views[MAX_COMPONENT_IDS];
+
+void ViewBase::registerView(std::initializer_list<ComponentID> IDs)
+{
+	for (ComponentID ID : IDs)
+	{
+		s_Views[ID].push_back(this);
+	}
+}
+
+void ViewBase::deregisterView(std::initializer_list<ComponentID> IDs)
+{
+	for (ComponentID ID : IDs)
+	{
+		Vector<ViewBase*>& views = s_Views[ID];
+		views.erase(std::remove(views.begin(), views.end(), this), views.end());
+	}
+}
+
+void ViewBase::ComponentAdded(Entity* entity, ComponentID ID)
+{
+	for (auto& view : s_Views[ID])
+	{
+		view->onComponentAdded(entity);
+	}
+}
+
+void ViewBase::ComponentRemoved(Entity* entity, ComponentID ID)
+{
+	for (auto& view : s_Views[ID])
+	{
+		view->onComponentRemoved(entity);
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "common/common.h"
+#include "entity.h"
+#include "system.h"
+
+/// Keeps track of the views interested in each ComponentID, so that Entity can tell them about components being added and removed.
+class ViewBase
+{
+	/// Indexed by ComponentID.
+	static Vector<ViewBase*> s_Views[MAX_COMPONENT_IDS];
+
+protected:
+	/// Keep this view told about the components with the given IDs.
+	void registerView(std::initializer_list<ComponentID> IDs);
+	void deregisterView(std::initializer_list<ComponentID> IDs);
+
+	/// Entity gained a component of a type this view queries.
+	virtual void onComponentAdded(Entity* entity) = 0;
+	/// Entity is about to lose a component of a type this view queries.
+	virtual void onComponentRemoved(Entity* entity) = 0;
+
+public:
+	/// Called by Entity after the component is put in its slot.
+	static void ComponentAdded(Entity* entity, ComponentID ID);
+	/// Called by Entity before the component is taken out of its slot.
+	static void ComponentRemoved(Entity* entity, ComponentID ID);
+
+	virtual ~ViewBase() = default;
+};
+
+/// Query over all entities that have every one of ComponentTypes.
+/// Keeps a list of the matching entities with pointers to their components, updated by Entity as components are added and removed,
+/// so walking a view doesn't look anything up. Views and entities are used on the main thread only, walking a view from systems
+/// updated in parallel is fine as long as no components are added or removed meanwhile.
+/// Component types sharing a ComponentID, like GridModelComponent and ModelComponent, should be queried by the type owning the ID.
+template <class... ComponentTypes>
+class View : public ViewBase
+{
+	typedef Tuple<Entity*, ComponentTypes*...> Match;
+
+	Vector<Match> m_Matches;
+	/// Position of each matching entity in m_Matches.
+	HashMap<Entity*, size_t> m_MatchIndices;
+
+	void onComponentAdded(Entity* entity) override;
+	void onComponentRemoved(Entity* entity) override;
+
+public:
+	/// Starts off with the entities already matching, found through the System component list of the least common queried type.
+	View();
+	View(View&) = delete;
+	~View();
+
+	/// Call callable(Entity*, ComponentTypes*...) for every matching entity.
+	/// Adding or removing components of the visited entities while iterating is not allowed.
+	template <class Callable>
+	void each(Callable&& callable);
+
+	/// Number of matching entities.
+	size_t size() const { return m_Matches.size(); }
+};
+
+template <class... ComponentTypes>
+inline View<ComponentTypes...>::View()
+{
+	const Vector<Component*>* smallest = nullptr;
+	for (ComponentID ID : { ComponentTypes::s_ID... })
+	{
+		const Vector<Component*>& components = System::GetComponents(ID);
+		if (!smallest || components.size() < smallest->size())
+		{
+			smallest = &components;
+		}
+	}
+	for (auto& component : *smallest)
+	{
+		if (Entity* entity = component->getOwnerPointer())
+		{
+			onComponentAdded(entity);
+		}
+	}
+
+	registerView({ ComponentTypes::s_ID... });
+}
+
+template <class... ComponentTypes>
+inline View<ComponentTypes...>::~View()
+{
+	deregisterView({ ComponentTypes::s_ID... });
+}
+
+template <class... ComponentTypes>
+inline void View<ComponentTypes...>::onComponentAdded(Entity* entity)
+{
+	if (m_MatchIndices.find(entity) != m_MatchIndices.end())
+	{
+		return;
+	}
+
+	Match match(entity, entity->getComponentPointer<ComponentTypes>()...);
+	if ((std::get<ComponentTypes*>(match) && ...))
+	{
+		m_MatchIndices[entity] = m_Matches.size();
+		m_Matches.push_back(match);
+	}
+}
+
+template <class... ComponentTypes>
+inline void View<ComponentTypes...>::onComponentRemoved(Entity* entity)
+{
+	auto findIt = m_MatchIndices.find(entity);
+	if (findIt == m_MatchIndices.end())
+	{
+		return;
+	}
+
+	// Fill the hole with the last match instead of shifting every match after it
+	size_t index = findIt->second;
+	m_MatchIndices.erase(findIt);
+	if (index != m_Matches.size() - 1)
+	{
+		m_Matches[index] = m_Matches.back();
+		m_MatchIndices[std::get<Entity*>(m_Matches[index])] = index;
+	}
+	m_Matches.pop_back();
+}
+
+template <class... ComponentTypes>
+template <class Callable>
+inline void View<ComponentTypes...>::each(Callable&& callable)
+{
+	for (auto& match : m_Matches)
+	{
+		std::apply(callable, match);
+	}
+}
@@ -130,9 +130,14 @@ LRESULT CALLBACK Window::WindowsProc(HWND windowHandler, UINT msg, WPARAM wParam
 		PostQuitMessage(0);
 		return 0;
 	case WM_SIZE:
-		EventManager::GetSingleton()->call("WindowProc", "WindowResized", Vector2(LOWORD(lParam), HIWORD(lParam)));
+	{
+		Vector2 size(LOWORD(lParam), HIWORD(lParam));
+		EventManager::GetSingleton()->call(WindowResized { size });
+		// Scripts can't see typed events and subscribe to the named event instead
+		EventManager::GetSingleton()->call("WindowProc", "WindowResized", size);
 		break;
 	}
+	}
 
 	InputInterface::ProcessWindowsEvent(msg, wParam, lParam);
 	InputManager::GetSingleton()->forwardMessage({ windowHandler, msg, wParam, lParam });
@@ -148,7 +153,7 @@ Window::Window(int xOffset, int yOffset, int width, int height, const String& ti
 	BIND_EVENT_MEMBER_FUNCTION("QuitEditorWindow", Window::quitEditorWindow);
 	BIND_EVENT_MEMBER_FUNCTION("WindowToggleFullScreen", Window::toggleFullScreen);
 	BIND_EVENT_MEMBER_FUNCTION("WindowGetScreenState", Window::getScreenState);
-	BIND_EVENT_MEMBER_FUNCTION("WindowResized", Window::windowResized);
+	BIND_TYPED_EVENT_MEMBER_FUNCTION(WindowResized, Window::windowResized);
 
 	WNDCLASSEX windowClass = { 0 };
 	LPCSTR className = title.c_str();
@@ -212,12 +217,10 @@ Variant Window::quitEditorWindow(const Event* event)
 	return true;
 }
 
-Variant Window::windowResized(const Event* event)
+void Window::windowResized(const WindowResized& resized)
 {
-	const Vector2& newSize = Extract(Vector2, event->getData());
-	setWindowSize(newSize);
+	setWindowSize(resized.m_Size);
 	applyDefaultViewport();
-	return true;
 }
 
 HWND Window::getWindowHandle()
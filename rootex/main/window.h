@@ -6,6 +6,12 @@
 
 #include "common/common.h"
 
+/// Typed event sent when the window is resized.
+struct WindowResized
+{
+	Vector2 m_Size;
+};
+
 /// Handles window creation.
 class Window
 {
@@ -24,7 +30,7 @@ protected:
 	static LRESULT CALLBACK WindowsProc(HWND windowHandler, UINT msg, WPARAM wParam, LPARAM lParam);
 	Variant quitWindow(const Event* event);
 	Variant quitEditorWindow(const Event* event);
-	Variant windowResized(const Event* event);
+	void windowResized(const WindowResized& resized);
 
 public:
 	Window(int xOffset, int yOffset, int width, int height, const String& title, bool isEditor, bool MSAA, bool fullScreen);
@@ -391,7 +391,65 @@ FileBuffer OS::LoadFileContents(String stringPath)
 	stream.read(buffer.data(), pos);
 
 	stream.close();
-	return FileBuffer(buffer);
+	return buffer;
+}
+
+Ref<FileMapping> OS::MapFileContents(String stringPath)
+{
+	Ref<FileMapping> mapping(new FileMapping());
+	if (!mapping->open(GetAbsolutePath(stringPath)))
+	{
+		return nullptr;
+	}
+	return mapping;
+}
+
+FileMapping::FileMapping()
+    : m_View(nullptr)
+    , m_Size(0)
+{
+}
+
+FileMapping::~FileMapping()
+{
+	if (m_View)
+	{
+		UnmapViewOfFile(m_View);
+	}
+}
+
+bool FileMapping::open(const FilePath& absolutePath)
+{
+	HANDLE file = CreateFileW(absolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	// The view keeps the file and the mapping alive on its own
+	CloseHandle(file);
+	if (!mapping)
+	{
+		return false;
+	}
+
+	m_View = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!m_View)
+	{
+		return false;
+	}
+
+	m_Size = size.QuadPart;
+	return true;
 }
 
 bool OS::IsExists(String relativePath)
@@ -463,7 +521,7 @@ bool OS::SaveFile(const FilePath& filePath, ResourceData* fileData)
 	try
 	{
 		outFile.open(GetAbsolutePath(filePath.generic_string()), std::ios::out | std::ios::binary);
-		outFile.write(fileData->getRawData()->data(), fileData->getRawDataByteSize());
+		outFile.write(fileData->getReadOnlyData(), fileData->getRawDataByteSize());
 	}
 	catch (std::exception e)
 	{
@@ -16,6 +16,25 @@ typedef std::chrono::time_point<std::filesystem::file_time_type::clock> FileTime
 
 class ResourceData;
 
+/// Read only view of a whole file mapped into memory. Pages of the file are read from disk only when they are touched.
+/// Other programs can still write to the file while it is mapped but can't shrink it.
+class FileMapping
+{
+	const char* m_View;
+	size_t m_Size;
+
+public:
+	FileMapping();
+	FileMapping(FileMapping&) = delete;
+	~FileMapping();
+
+	/// Returns false if the file could not be mapped. Empty files can't be mapped.
+	bool open(const FilePath& absolutePath);
+
+	const char* getData() const { return m_View; }
+	size_t getSize() const { return m_Size; }
+};
+
 /// Provides features that are provided directly by the OS.
 class OS
 {
@@ -48,6 +67,8 @@ public:
 
 	static bool IsExists(String relativePath);
 	static FileBuffer LoadFileContents(String stringPath);
+	/// Map the file into memory instead of reading it. Returns nullptr if the file could not be mapped.
+	static Ref<FileMapping> MapFileContents(String stringPath);
 	static FilePath GetAbsolutePath(String stringPath);
 	static FilePath GetRootRelativePath(String stringPath);
 	static FilePath GetRelativePath(String stringPath, String base);
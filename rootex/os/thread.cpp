@@ -1,230 +1,332 @@
 #include "thread.h"
-#include <Windows.h>
 
-/// The main function which runs on every thread.
-DWORD WINAPI MainLoop(LPVOID voidParameters);
+/// Index of the worker deque owned by the current thread. Threads outside the pool have none.
+static thread_local int t_WorkerIndex = -1;
+/// Pool that owns the current thread.
+static thread_local ThreadPool* t_WorkerPool = nullptr;
 
-Task::Task(const Function<void()>& executionTask)
-    : m_ExecutionTask(executionTask)
+TaskCounter::TaskCounter(int pending)
+    : m_Pending(pending)
 {
 }
 
-void Task::execute()
+void TaskCounter::increment(int count)
 {
-	m_ExecutionTask();
+	m_Pending += count;
 }
 
-void ThreadPool::initialize()
+void TaskCounter::decrement()
 {
-	SYSTEM_INFO sysInfo;
-	GetSystemInfo(&sysInfo);
-	m_Threads = sysInfo.dwNumberOfProcessors;
+	if (--m_Pending == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_DoneVariable.notify_all();
+	}
+}
 
-	m_IsRunning = true;
+Task::Task(const Function<void()>& executionTask)
+    : m_ExecutionTask(executionTask)
+    , m_DependencyCount(0)
+    , m_PendingDependencies(0)
+{
+}
 
-	InitializeConditionVariable(&m_ConsumerVariable);
-	InitializeConditionVariable(&m_ProducerVariable);
-	InitializeCriticalSection(&m_CriticalSection);
+void Task::addContinuation(const Ref<Task>& continuation)
+{
+	m_Continuations.push_back(continuation);
+	continuation->m_DependencyCount++;
+}
 
-	m_DefaultWorkerParameter.m_Thread = 0;
-	m_DefaultWorkerParameter.m_ThreadPool = NULL;
+void Task::execute()
+{
+	m_ExecutionTask();
+}
 
-	{
-		m_TaskQueue.m_Read = 0;
-		m_TaskQueue.m_Write = 0;
-		m_TaskQueue.m_Jobs = 0;
-		m_TasksFinished = 0;
-		m_TasksComplete.m_Jobs = 0;
-	}
+void TaskDeque::push(const Ref<Task>& task)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Tasks.push_back(task);
+}
 
-	for (__int32 iThread = 0; iThread < m_Threads; iThread++)
+Ref<Task> TaskDeque::pop()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (m_Tasks.empty())
 	{
-		m_WorkerParameters.push_back(m_DefaultWorkerParameter);
-		m_Handles.push_back(m_DefaultHandle);
+		return nullptr;
 	}
+	Ref<Task> task = std::move(m_Tasks.back());
+	m_Tasks.pop_back();
+	return task;
+}
 
-	for (__int32 iThread = 0; iThread < m_Threads; iThread++)
+Ref<Task> TaskDeque::steal()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (m_Tasks.empty())
 	{
-		m_WorkerParameters[iThread].m_Thread = iThread;
-		m_WorkerParameters[iThread].m_ThreadPool = this;
-		m_Handles[iThread] = CreateThread(NULL, 0, MainLoop, &m_WorkerParameters[iThread], 0, 0);
+		return nullptr;
 	}
+	Ref<Task> task = std::move(m_Tasks.front());
+	m_Tasks.pop_front();
+	return task;
 }
 
-DWORD WINAPI MainLoop(LPVOID voidParameters)
+void ThreadPool::initialize()
 {
-	const struct WorkerParameters* parameters = (struct WorkerParameters*)voidParameters;
-
-	const __int32 iThread = parameters->m_Thread;
-	ThreadPool& threadPool = *parameters->m_ThreadPool;
+	unsigned int threads = std::thread::hardware_concurrency();
+	// Main thread is not a worker but it lends a hand while waiting
+	threads = threads > 1 ? threads - 1 : 1;
 
-	__int32 taskId = -1;
-	__int32 increment = 0;
+	m_IsRunning = true;
+	m_NextQueue = 0;
+	m_QueuedTasks = 0;
+	m_SleepingWorkers = 0;
 
-	while (true)
+	for (unsigned int i = 0; i < threads; i++)
 	{
-		EnterCriticalSection(&threadPool.m_CriticalSection);
-
-		/*if (m_ThreadPool.m_TasksComplete.m_Jobs > 0)
-		{
-			m_ThreadPool.m_TasksComplete.ids.push_back(taskId);
-			m_ThreadPool.m_TasksComplete.m_Jobs += increment;
-			m_ThreadPool.m_TasksFinished += increment;
-			increment++;
-			std::cout << increment;
-		}*/
-
-		WakeAllConditionVariable(&threadPool.m_ProducerVariable);
+		m_Queues.emplace_back(new TaskDeque());
+	}
+	for (unsigned int i = 0; i < threads; i++)
+	{
+		m_Workers.emplace_back(&ThreadPool::mainLoop, this, i);
+	}
+}
 
-		while ((threadPool.m_TaskQueue.m_Jobs == 0) && threadPool.m_IsRunning)
-		{
-			SleepConditionVariableCS(&threadPool.m_ConsumerVariable, &threadPool.m_CriticalSection, INFINITE);
-		}
+void ThreadPool::mainLoop(unsigned int worker)
+{
+	t_WorkerIndex = worker;
+	t_WorkerPool = this;
 
-		if (threadPool.m_IsRunning == false)
+	while (m_IsRunning)
+	{
+		if (runPendingTask())
 		{
-			LeaveCriticalSection(&threadPool.m_CriticalSection);
-			return 0;
+			continue;
 		}
 
-		taskId = threadPool.m_TaskQueue.m_QueueJobs[threadPool.m_TaskQueue.m_Read]->m_ID;
-		__int32 readTemp = threadPool.m_TaskQueue.m_Read;
-		threadPool.m_TaskQueue.m_Jobs--;
-		threadPool.m_TaskQueue.m_Read++;
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_SleepingWorkers++;
+		m_SleepVariable.wait(lock, [this]() { return m_QueuedTasks.load() > 0 || !m_IsRunning; });
+		m_SleepingWorkers--;
+	}
+}
 
-		LeaveCriticalSection(&threadPool.m_CriticalSection);
+void ThreadPool::enqueue(const Ref<Task>& task)
+{
+	if (t_WorkerPool == this)
+	{
+		// Tasks spawned from inside tasks stay on the same worker for locality
+		m_Queues[t_WorkerIndex]->push(task);
+	}
+	else
+	{
+		m_Queues[m_NextQueue++ % m_Queues.size()]->push(task);
+	}
+	m_QueuedTasks++;
 
-		threadPool.m_TaskQueue.m_QueueJobs[readTemp]->execute();
-		threadPool.m_TasksComplete.m_Jobs++;
+	if (m_SleepingWorkers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_SleepVariable.notify_one();
 	}
-	return 0;
 }
 
-void ThreadPool::submit(Vector<Ref<Task>>& tasks)
+bool ThreadPool::runPendingTask()
 {
-	join();
+	Ref<Task> task;
+	unsigned int start = 0;
+	if (t_WorkerPool == this)
+	{
+		task = m_Queues[t_WorkerIndex]->pop();
+		start = t_WorkerIndex + 1;
+	}
+	else
+	{
+		start = m_NextQueue.load();
+	}
 
-	MasterThread masterThread;
-	masterThread.m_TasksComplete.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Jobs = 0;
-	masterThread.m_TasksReady.m_Read = 0;
-	masterThread.m_TasksReady.m_Write = 0;
+	for (unsigned int i = 0; !task && i < m_Queues.size(); i++)
+	{
+		task = m_Queues[(start + i) % m_Queues.size()]->steal();
+	}
 
-	bool isTasksRemaining = true;
+	if (!task)
+	{
+		return false;
+	}
 
-	m_TasksFinished = 0;
+	m_QueuedTasks--;
+	Ref<TaskCounter> counter = task->m_Counter;
+	task->execute();
 
+	for (auto& continuation : task->m_Continuations)
 	{
-		static __int32 idIndex = 0;
-		for (auto iJob : tasks)
+		if (--continuation->m_PendingDependencies == 0)
 		{
-			iJob->m_Dependencies = 0;
-			m_TaskQueue.m_QueueJobs.push_back(iJob);
-			m_TaskQueue.m_QueueJobs[idIndex]->m_ID = idIndex;
-			idIndex++;
+			enqueue(continuation);
 		}
-
-		/*for (__int32 i_Job = 0; i_Job < tasks.size(); i_Job++)
-		{
-			for (__int32 i_Permission = 0; i_Permission < tasks[i_Job]->m_Permisions; i_Permission++)
-			{
-				tasks[tasks[i_Job]->i_Permissions[i_Permission]]->m_Dependencies++;
-			}
-		}*/
 	}
 
-	while (isTasksRemaining)
+	counter->decrement();
+	m_AllTasks.decrement();
+	return true;
+}
+
+bool ThreadPool::IsRunnableGraph(const Vector<Ref<Task>>& tasks)
+{
+	// Plain batches, like the ones from parallelFor(), need no checking
+	if (std::all_of(tasks.begin(), tasks.end(), [](const Ref<Task>& task) { return task->m_Continuations.empty() && task->m_DependencyCount == 0; }))
 	{
+		return true;
+	}
 
-		/*{
-			const __int32 nJobs = master_thread.m_TasksComplete.m_Jobs;
-			for (__int32 i_job = 0; i_job < nJobs; i_job++)
-			{
-				__int32 taskId = master_thread.m_TasksComplete.ids[i_job];
+	HashMap<Task*, int> inBatchDependencies;
+	for (auto& task : tasks)
+	{
+		inBatchDependencies[task.get()] = 0;
+	}
 
-				for (__int32 i_Permission = 0; i_Permission < tasks[taskId]->m_Permisions; i_Permission++)
-				{
-					tasks[tasks[taskId]->i_Permissions[i_Permission]]->m_Dependencies--;
-				}
-				master_thread.m_TasksComplete.m_Jobs--;
-			}
-		}*/
+	for (auto& task : tasks)
+	{
+		for (auto& continuation : task->m_Continuations)
 		{
-			__int32 iJob = 0;
-			while (iJob < tasks.size())
+			auto findIt = inBatchDependencies.find(continuation.get());
+			if (findIt == inBatchDependencies.end())
 			{
-				if (tasks[iJob]->m_Dependencies == 0)
-				{
-					masterThread.m_TasksReady.m_IDs.push_back(tasks[iJob]->m_ID);
-					masterThread.m_TasksReady.m_Write++;
-					masterThread.m_TasksReady.m_Jobs++;
-					tasks[iJob]->m_Dependencies--;
-				}
-				iJob++;
+				ERR("Submitted task has a continuation that is not submitted with it, none of the tasks will run");
+				return false;
 			}
+			findIt->second++;
 		}
+	}
 
-		EnterCriticalSection(&m_CriticalSection);
+	Vector<Task*> ready;
+	for (auto& task : tasks)
+	{
+		if (inBatchDependencies[task.get()] != task->m_DependencyCount)
+		{
+			ERR("Submitted task depends on a task that is not submitted with it, none of the tasks will run");
+			return false;
+		}
+		if (task->m_DependencyCount == 0)
+		{
+			ready.push_back(task.get());
+		}
+	}
 
+	// Kahn's algorithm, every task gets visited only if the graph has no cycles
+	size_t visited = 0;
+	while (!ready.empty())
+	{
+		Task* task = ready.back();
+		ready.pop_back();
+		visited++;
+		for (auto& continuation : task->m_Continuations)
 		{
-			__int32 nJobs = masterThread.m_TasksReady.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
+			if (--inBatchDependencies[continuation.get()] == 0)
 			{
-				m_TaskQueue.m_QueueJobs[m_TaskQueue.m_Write]->m_ID = masterThread.m_TasksReady.m_IDs[masterThread.m_TasksReady.m_Read];
-				m_TaskQueue.m_Write++;
-				m_TaskQueue.m_Jobs++;
-				m_TasksFinished++;
-				masterThread.m_TasksReady.m_Read++;
-				masterThread.m_TasksReady.m_Jobs--;
+				ready.push_back(continuation.get());
 			}
 		}
+	}
+
+	if (visited != inBatchDependencies.size())
+	{
+		ERR("Submitted tasks have cyclic dependencies, none of them will run");
+		return false;
+	}
+	return true;
+}
+
+Ref<TaskCounter> ThreadPool::submit(const Vector<Ref<Task>>& tasks)
+{
+	if (!IsRunnableGraph(tasks))
+	{
+		// Nothing runs, so there is nothing to wait for
+		return Ref<TaskCounter>(new TaskCounter(0));
+	}
+
+	Ref<TaskCounter> counter(new TaskCounter(tasks.size()));
+	m_AllTasks.increment(tasks.size());
 
-		WakeAllConditionVariable(&m_ConsumerVariable);
+	for (auto& task : tasks)
+	{
+		task->m_Counter = counter;
+		task->m_PendingDependencies = task->m_DependencyCount;
+	}
 
-		while ((m_TasksComplete.m_Jobs == 0) && m_IsRunning)
+	for (auto& task : tasks)
+	{
+		if (task->m_DependencyCount == 0)
 		{
-			SleepConditionVariableCS(&m_ProducerVariable, &m_CriticalSection, INFINITE);
+			enqueue(task);
 		}
+	}
 
-		/*{
-			const __int32 nJobs = m_TasksComplete.m_Jobs;
-			for (__int32 i_Job = 0; i_Job < nJobs; i_Job++)
-			{
+	return counter;
+}
 
-				master_thread.m_TasksComplete.ids[i_Job] = m_TasksComplete.ids[i_Job];
-				master_thread.m_TasksComplete.m_Jobs++;
-				m_TasksComplete.m_Jobs--;
-			}
-		}*/
+Ref<TaskCounter> ThreadPool::submit(const Function<void()>& job)
+{
+	return submit(Vector<Ref<Task>> { Ref<Task>(new Task(job)) });
+}
 
-		isTasksRemaining = m_TasksFinished < tasks.size();
+void ThreadPool::parallelFor(size_t count, const Function<void(size_t begin, size_t end)>& batch, size_t grainSize)
+{
+	grainSize = grainSize ? grainSize : 1;
+	if (count <= grainSize)
+	{
+		if (count)
+		{
+			batch(0, count);
+		}
+		return;
+	}
 
-		LeaveCriticalSection(&m_CriticalSection);
+	Vector<Ref<Task>> tasks;
+	tasks.reserve((count + grainSize - 1) / grainSize);
+	for (size_t begin = 0; begin < count; begin += grainSize)
+	{
+		size_t end = std::min(begin + grainSize, count);
+		tasks.emplace_back(new Task([&batch, begin, end]() { batch(begin, end); }));
 	}
-}
 
-bool ThreadPool::isCompleted() const
-{
-	return m_TaskQueue.m_QueueJobs.size() == m_TasksComplete.m_Jobs;
+	wait(submit(tasks));
 }
 
-void ThreadPool::join() const
+void ThreadPool::wait(TaskCounter& counter)
 {
-	while (!isCompleted())
+	while (!counter.isDone())
 	{
-		;
+		if (runPendingTask())
+		{
+			continue;
+		}
+
+		// Nothing left to help with, the remaining tasks are already running on other workers
+		std::unique_lock<std::mutex> lock(counter.m_Mutex);
+		counter.m_DoneVariable.wait(lock, [&counter]() { return counter.isDone(); });
 	}
 }
 
+void ThreadPool::join()
+{
+	wait(m_AllTasks);
+}
+
 void ThreadPool::shutDown()
 {
-	EnterCriticalSection(&this->m_CriticalSection);
 	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
 		m_IsRunning = false;
 	}
-	LeaveCriticalSection(&this->m_CriticalSection);
-	WakeAllConditionVariable(&this->m_ConsumerVariable);
-	WaitForMultipleObjects(m_Threads, m_Handles.data(), TRUE, INFINITE);
+	m_SleepVariable.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
 }
 
 ThreadPool::ThreadPool()
@@ -2,97 +2,228 @@
 
 #include "common/common.h"
 
-#include <Windows.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
-/// Interface for spawning and maintenance of threads.
-class ThreadPool;
+/// Waitable count of tasks that are yet to finish. Returned by ThreadPool::submit().
+class TaskCounter
+{
+	Atomic<int> m_Pending;
+	std::mutex m_Mutex;
+	std::condition_variable m_DoneVariable;
+
+	friend class ThreadPool;
+
+public:
+	TaskCounter(int pending = 0);
+	TaskCounter(TaskCounter&) = delete;
+	~TaskCounter() = default;
+
+	void increment(int count = 1);
+	/// Wakes up all waiters when the count reaches 0.
+	void decrement();
+
+	/// Returns true if all tasks counted by this have been completed
+	bool isDone() const { return m_Pending.load() <= 0; }
+	int getPending() const { return m_Pending.load(); }
+};
 
 /// Defines jobs to be run on threads.
+/// Tasks can depend on other tasks, forming a graph that runs a task only after all of its dependencies are done.
 class Task
 {
-public:
-	__int32 m_ID;
-	__int32 m_Dependencies;
-	Vector<__int32> m_Permissions;
 	Function<void()> m_ExecutionTask;
+	Ref<TaskCounter> m_Counter;
+
+	/// Tasks that depend on this task. These are notified when this task completes.
+	Vector<Ref<Task>> m_Continuations;
+	/// Number of tasks this task depends on.
+	int m_DependencyCount;
+	/// Dependencies yet to complete in the current submission.
+	Atomic<int> m_PendingDependencies;
 
+	friend class ThreadPool;
+
+public:
 	Task(const Function<void()>& executionTask);
-	Task(const Task&) = default;
+	Task(const Task&) = delete;
 	~Task() = default;
 
+	/// Make the continuation wait for this task to complete. Both tasks should be submitted together.
+	void addContinuation(const Ref<Task>& continuation);
+
 	void execute();
 };
 
-/// Worker thread parameters.
-struct WorkerParameters
+/// Double ended queue of tasks owned by a single worker.
+/// The owner pushes and pops at the back, other workers steal from the front.
+class TaskDeque
 {
-	__int32 m_Thread;
-	ThreadPool* m_ThreadPool;
-};
+	std::mutex m_Mutex;
+	std::deque<Ref<Task>> m_Tasks;
 
-/// A queue of jobs.
-struct TaskQueue
-{
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
-	unsigned __int32 m_Read;
-	Vector<Ref<Task>> m_QueueJobs;
+public:
+	TaskDeque() = default;
+	TaskDeque(TaskDeque&) = delete;
+	~TaskDeque() = default;
+
+	void push(const Ref<Task>& task);
+	/// Returns nullptr if empty. Used by the owning worker.
+	Ref<Task> pop();
+	/// Returns nullptr if empty. Used by the other workers.
+	Ref<Task> steal();
 };
 
-/// Contains the information of completed jobs.
-struct TaskComplete
+/// Lock-free queue that any number of threads can push into while a single thread drains it.
+template <class T>
+class ConcurrentQueue
 {
-	__int32 m_Jobs;
-	Vector<__int32> m_IDs;
-};
+	struct Node
+	{
+		T m_Value;
+		Node* m_Next;
+	};
 
-/// Contains information of jobs ready for execution.
-struct TaskReady
-{	
-	__int32 m_Jobs;
-	unsigned __int32 m_Write;
-	unsigned __int32 m_Read;
-	Vector<__int32> m_IDs;
-};
+	/// Most recently pushed node. Nodes link towards older nodes.
+	Atomic<Node*> m_Head;
 
-/// Master thread to communicate with and maintain worker threads.
-struct MasterThread
-{	
-	TaskComplete m_TasksComplete;
-	TaskReady m_TasksReady;
+public:
+	ConcurrentQueue();
+	ConcurrentQueue(ConcurrentQueue&) = delete;
+	~ConcurrentQueue();
+
+	/// Safe to call from any thread.
+	void push(T value);
+	/// Append everything pushed so far to values, oldest first. Only one thread should pop at a time.
+	void popAll(Vector<T>& values);
+
+	bool isEmpty() const { return m_Head.load() == nullptr; }
 };
 
+/// Default number of loop iterations that are run by a single task in ThreadPool::parallelFor().
+#define DEFAULT_GRAIN_SIZE 256
+
+/// Work stealing scheduler that maintains a worker thread per hardware thread, except the main thread.
+/// Submitting is non-blocking and tasks are free to submit and wait on other tasks.
 class ThreadPool
 {
-	bool m_IsRunning;
-	__int32 m_Threads;
-	Vector<WorkerParameters> m_WorkerParameters;
-	WorkerParameters m_DefaultWorkerParameter;
-	Vector<HANDLE> m_Handles;
-	HANDLE m_DefaultHandle = 0;
-	CONDITION_VARIABLE m_ConsumerVariable;
-	CONDITION_VARIABLE m_ProducerVariable;
-	CRITICAL_SECTION m_CriticalSection;
-
-	__int32 m_TasksFinished;
-	TaskQueue m_TaskQueue;
-	TaskComplete m_TasksComplete;
-
-	friend DWORD WINAPI MainLoop(LPVOID voidParameters);
+	Atomic<bool> m_IsRunning;
+	Vector<std::thread> m_Workers;
+	Vector<Ptr<TaskDeque>> m_Queues;
+	Atomic<unsigned int> m_NextQueue;
+
+	/// Tasks sitting in the queues, used to put idle workers to sleep.
+	Atomic<int> m_QueuedTasks;
+	Atomic<int> m_SleepingWorkers;
+	std::mutex m_SleepMutex;
+	std::condition_variable m_SleepVariable;
+
+	/// Counts every task submitted to the pool.
+	TaskCounter m_AllTasks;
 
 	void initialize();
 	void shutDown();
 
+	/// The main function which runs on every worker thread.
+	void mainLoop(unsigned int worker);
+	void enqueue(const Ref<Task>& task);
+	/// Pops or steals a task and runs it. Returns false if there was no task to run.
+	bool runPendingTask();
+	/// Returns false if the tasks have cyclic dependencies or dependencies on tasks outside of them.
+	static bool IsRunnableGraph(const Vector<Ref<Task>>& tasks);
+
 public:
 	ThreadPool();
 	ThreadPool(ThreadPool&) = delete;
-	~ThreadPool();	
+	~ThreadPool();
+
+	/// To submit jobs to the jobs queue. Returns immediately with a counter that reaches 0 when all the jobs are done.
+	/// Jobs with dependencies are queued only after their dependencies are done.
+	/// Dependencies should form a graph without cycles inside tasks, otherwise none of the tasks run and the returned counter is already done.
+	Ref<TaskCounter> submit(const Vector<Ref<Task>>& tasks);
+	/// To submit a single job to the jobs queue.
+	Ref<TaskCounter> submit(const Function<void()>& job);
+
+	/// Returns when the counter reaches 0. Runs pending tasks on the calling thread while it waits.
+	void wait(TaskCounter& counter);
+	void wait(const Ref<TaskCounter>& counter) { wait(*counter); }
 
-	/// To submit a job to the jobs queue.
-	void submit(Vector<Ref<Task>>& tasks);
+	/// Split [0, count) into batches of grainSize iterations and run them in parallel. Returns when all batches are done.
+	void parallelFor(size_t count, const Function<void(size_t begin, size_t end)>& batch, size_t grainSize = DEFAULT_GRAIN_SIZE);
+	/// Reduce each batch of [0, count) to a value in parallel and combine those values in order, starting from identity.
+	template <class T>
+	T parallelReduce(size_t count, const T& identity, const Function<T(size_t begin, size_t end)>& batch, const Function<T(const T&, const T&)>& combine, size_t grainSize = DEFAULT_GRAIN_SIZE);
 
 	/// Returns true if all tasks have been completed
-	bool isCompleted() const;
+	bool isCompleted() const { return m_AllTasks.isDone(); }
 	/// Returns when all the tasks have been completed
-	void join() const;
+	void join();
+
+	unsigned int getWorkerCount() const { return m_Workers.size(); }
 };
+
+template <class T>
+inline T ThreadPool::parallelReduce(size_t count, const T& identity, const Function<T(size_t begin, size_t end)>& batch, const Function<T(const T&, const T&)>& combine, size_t grainSize)
+{
+	grainSize = grainSize ? grainSize : 1;
+	Vector<T> results((count + grainSize - 1) / grainSize, identity);
+	parallelFor(
+	    count, [&](size_t begin, size_t end) {
+		    results[begin / grainSize] = batch(begin, end);
+	    },
+	    grainSize);
+
+	T result = identity;
+	for (auto& batchResult : results)
+	{
+		result = combine(result, batchResult);
+	}
+	return result;
+}
+
+template <class T>
+inline ConcurrentQueue<T>::ConcurrentQueue()
+    : m_Head(nullptr)
+{
+}
+
+template <class T>
+inline ConcurrentQueue<T>::~ConcurrentQueue()
+{
+	Node* node = m_Head.exchange(nullptr);
+	while (node)
+	{
+		Node* next = node->m_Next;
+		delete node;
+		node = next;
+	}
+}
+
+template <class T>
+inline void ConcurrentQueue<T>::push(T value)
+{
+	Node* node = new Node { std::move(value), m_Head.load(std::memory_order_relaxed) };
+	while (!m_Head.compare_exchange_weak(node->m_Next, node, std::memory_order_release, std::memory_order_relaxed))
+	{
+		;
+	}
+}
+
+template <class T>
+inline void ConcurrentQueue<T>::popAll(Vector<T>& values)
+{
+	// Detaching the whole list at once leaves no room for ABA problems
+	Node* node = m_Head.exchange(nullptr, std::memory_order_acquire);
+
+	size_t start = values.size();
+	while (node)
+	{
+		values.push_back(std::move(node->m_Value));
+		Node* next = node->m_Next;
+		delete node;
+		node = next;
+	}
+	std::reverse(values.begin() + start, values.end());
+}